@@ -0,0 +1,51 @@
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include "generators/delta_decoder.h"
+#include "fullerene/fullerene_writer.h"
+
+static void print_usage() {
+    std::cerr << "Usage: fullerene_delta_decoder [--format text|binary|planar_code] < delta_stream\n";
+}
+
+int main(int argc, char** argv) {
+    auto format = output_format::TEXT;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--format" && i + 1 < argc) {
+            // a delta stream decodes to graphs, not to another delta stream or a tally
+            if (!parse_output_format(argv[++i], format) || format == output_format::DELTA
+                || format == output_format::COUNT) {
+                std::cerr << "Unsupported output format: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    try {
+        if (!read_delta_header(std::cin)) {
+            throw std::runtime_error("Input is not a fullerene delta stream");
+        }
+
+        fullerene_writer out(std::cout, format);
+        delta_decoder decoder;
+        delta_record record;
+        fullerene primal;
+
+        while (read_delta_record(std::cin, record)) {
+            decoder.decode(record).to_primal_into(primal);
+            out.write(primal);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Delta decoder error: " << ex.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,19 +1,277 @@
+#include "generators/emit_pipeline.h"
 #include "generators/f_expansion_generator.h"
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include "generators/main_generator.h"
+#include "generators/search_checkpoint.h"
+#include "fullerene/fullerene_writer.h"
 
+static void print_usage() {
+    std::cerr << "Usage: fullerene_generator <max_size> [--format text|binary|planar_code|delta|count] [--threads <n>]"
+                 " [--split <res>/<mod>] [--split-depth <d>] [--estimate <probes>] [--output <file>]"
+                 " [--min-size <n> | --only-size <n>] [--ipr | --pentagon-distance <k>]"
+                 " [--checkpoint <file> [--checkpoint-interval <seconds>] [--resume]] [--async-output]"
+                 " [--ordered-output [--reorder-window <records>]]\n";
+}
 
-int main(int argc, char** argv) {
+static void print_estimate(const search_estimate& estimate) {
+    std::cout << "# search estimate from " << estimate.probes << " probes, without the F-expansion chain\n";
+    std::cout << "# atoms graphs\n";
+    for (std::size_t atoms = 0; atoms < estimate.graphs_per_size.size(); ++atoms) {
+        if (estimate.graphs_per_size[atoms] > 0) {
+            std::cout << atoms << " " << estimate.graphs_per_size[atoms] << "\n";
+        }
+    }
+    std::cout << "# depth graphs\n";
+    for (std::size_t depth = 0; depth < estimate.graphs_per_depth.size(); ++depth) {
+        std::cout << depth << " " << estimate.graphs_per_depth[depth] << "\n";
+    }
+    std::cout << "# total " << estimate.graphs << " graphs, " << estimate.seconds << " s sequential\n";
+}
+
+// "<res>/<mod>" with res < mod
+static bool parse_split(const std::string_view text, search_split& split) {
+    const auto slash = text.find('/');
+    if (slash == std::string_view::npos) {
+        return false;
+    }
+    const auto res = text.substr(0, slash);
+    const auto mod = text.substr(slash + 1);
+    const auto [res_end, res_error] = std::from_chars(res.data(), res.data() + res.size(), split.res);
+    const auto [mod_end, mod_error] = std::from_chars(mod.data(), mod.data() + mod.size(), split.mod);
+    return res_error == std::errc() && res_end == res.data() + res.size()
+        && mod_error == std::errc() && mod_end == mod.data() + mod.size()
+        && split.res < split.mod;
+}
+
+static int run(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: fullerene_generator <max_size>\n";
+        print_usage();
         return 1;
     }
 
     size_t max_size = std::stoul(argv[1]);
-    auto generator = f_expansion_generator();
-    generator.generate(max_size);
+    auto format = output_format::TEXT;
+    std::size_t threads = 1;
+    search_split split;
+    std::size_t estimate_probes = 0;
+    std::string output_file;
+    std::string checkpoint_file;
+    double checkpoint_interval = 5;
+    bool resume = false;
+    bool async_output = false;
+    bool ordered_output = false;
+    std::size_t reorder_window = main_generator::DEFAULT_REORDER_WINDOW;
+    std::size_t min_size = 0;
+    unsigned int pentagon_distance = 1;
+
+    for (int i = 2; i < argc; i++) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--format" && i + 1 < argc) {
+            if (!parse_output_format(argv[++i], format)) {
+                std::cerr << "Unknown output format: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoul(argv[++i]);
+        }
+        else if (arg == "--split" && i + 1 < argc) {
+            if (!parse_split(argv[++i], split)) {
+                std::cerr << "Invalid split, expected <res>/<mod>: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--split-depth" && i + 1 < argc) {
+            split.depth = std::stoi(argv[++i]);
+        }
+        else if (arg == "--estimate" && i + 1 < argc) {
+            estimate_probes = std::stoul(argv[++i]);
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpoint_file = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            checkpoint_interval = std::stod(argv[++i]);
+        }
+        else if (arg == "--min-size" && i + 1 < argc) {
+            min_size = std::stoul(argv[++i]);
+        }
+        else if (arg == "--only-size" && i + 1 < argc) {
+            min_size = std::stoul(argv[++i]);
+            max_size = std::min(max_size, min_size);
+        }
+        else if (arg == "--ipr") {
+            pentagon_distance = 2;
+        }
+        else if (arg == "--pentagon-distance" && i + 1 < argc) {
+            pentagon_distance = static_cast<unsigned int>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--async-output") {
+            async_output = true;
+        }
+        else if (arg == "--ordered-output") {
+            ordered_output = true;
+        }
+        else if (arg == "--reorder-window" && i + 1 < argc) {
+            reorder_window = std::stoul(argv[++i]);
+        }
+        else if (arg == "--resume") {
+            resume = true;
+        }
+        else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (estimate_probes > 0) {
+        // the estimate writes no graphs
+        fullerene_writer unused(std::cout);
+        auto generator = main_generator(unused);
+        generator.set_min_pentagon_distance(pentagon_distance);
+        print_estimate(generator.estimate(max_size, estimate_probes));
+        return 0;
+    }
 
-    auto generator_main = main_generator();
+    // every delta record needs its parent's record before it
+    if ((min_size > 0 || pentagon_distance > 1) && format == output_format::DELTA) {
+        std::cerr << "Delta streams can't leave out graphs, only full runs can be written as deltas\n";
+        return 1;
+    }
+
+    // a slice's records name parents written by slice 0 or by other slices
+    if (split.enabled() && format == output_format::DELTA) {
+        std::cerr << "Delta streams can't be split, every record needs its parent's record before it\n";
+        return 1;
+    }
+
+    if (resume && checkpoint_file.empty()) {
+        std::cerr << "--resume needs the --checkpoint file to resume from\n";
+        return 1;
+    }
+
+    if (!checkpoint_file.empty() && threads > 1) {
+        std::cerr << "Checkpoints need a sequential search, split the run instead of using threads\n";
+        return 1;
+    }
+
+    if (!checkpoint_file.empty() && format == output_format::COUNT) {
+        std::cerr << "Counting runs keep their counts in memory and can't be checkpointed\n";
+        return 1;
+    }
+
+    std::optional<search_checkpoint> checkpoint;
+    if (resume) {
+        checkpoint = read_checkpoint(checkpoint_file);
+    }
+
+    // a resumed run drops whatever was written after its checkpoint and appends from there
+    std::ofstream output;
+    if (!output_file.empty()) {
+        if (checkpoint) {
+            std::filesystem::resize_file(output_file, checkpoint->output_bytes);
+            output.open(output_file, std::ios::binary | std::ios::app);
+        }
+        else {
+            output.open(output_file, std::ios::binary | std::ios::trunc);
+        }
+        if (!output) {
+            std::cerr << "Could not open " << output_file << "\n";
+            return 1;
+        }
+    }
+    else if (checkpoint) {
+        std::cerr << "Resuming: truncate the previous output to " << checkpoint->output_bytes
+                  << " bytes before appending this one\n";
+    }
+    std::ostream& os = output_file.empty() ? std::cout : output;
+
+    std::optional<fullerene_writer> writer;
+    if (checkpoint) {
+        writer.emplace(os, format, continued_stream{ checkpoint->output_bytes });
+    }
+    else {
+        writer.emplace(os, format);
+    }
+    auto& out = *writer;
+
+    // formats and writes on its own thread, so slow consumers of the output don't stall the search
+    std::optional<emit_pipeline> pipeline;
+    if (async_output && format != output_format::COUNT) {
+        pipeline.emplace(out);
+    }
+    emit_pipeline* const pipeline_ptr = pipeline ? &*pipeline : nullptr;
+    const auto flush = [&] {
+        if (pipeline) {
+            pipeline->drain();
+        }
+        out.flush();
+    };
+
+    // the F-expansion chain is short, slice 0 writes it whole before any checkpoint is taken; the other
+    // slices only take its ids, which come before those of the search in every run
+    if (!checkpoint) {
+        auto generator = f_expansion_generator(out);
+        generator.set_written(split.res == 0);
+        generator.set_emitted_sizes(min_size, max_size);
+        generator.set_min_pentagon_distance(pentagon_distance);
+        generator.set_pipeline(pipeline_ptr);
+        generator.generate(max_size);
+        flush();
+    }
+
+    auto generator_main = main_generator(out, threads, split);
+    generator_main.set_emitted_sizes(min_size, max_size);
+    generator_main.set_min_pentagon_distance(pentagon_distance);
+    generator_main.set_pipeline(pipeline_ptr);
+    if (ordered_output) {
+        generator_main.set_ordered_output(reorder_window);
+    }
+    if (!checkpoint_file.empty()) {
+        generator_main.enable_checkpoints(checkpoint_file, std::chrono::duration<double>(checkpoint_interval));
+    }
+    if (checkpoint) {
+        generator_main.resume_from(std::move(*checkpoint));
+    }
     generator_main.generate(max_size);
+    if (format == output_format::COUNT) {
+        out.write_counts();
+    }
+    flush();
+
+    if ((ordered_output || format == output_format::DELTA) && threads > 1) {
+        const auto& stats = generator_main.get_reorder_stats();
+        std::cerr << "# reorder buffer: " << stats.records << " records, " << stats.buffered << " buffered, peak "
+                  << stats.peak_buffered << " of " << reorder_window << ", " << stats.window_waits << " waits for the window\n";
+    }
+
+    // a finished run has nothing left to resume
+    if (!checkpoint_file.empty()) {
+        std::filesystem::remove(checkpoint_file);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // e.g. a checkpoint of another run or an unreadable one
+    try {
+        return run(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
 }
@@ -21,9 +21,16 @@ std::vector<b_expansion_candidate> find_b_candidates(const dual_fullerene& G,
     int length_pre_bend,
     int length_post_bend);
 
+// the candidates of every split with pre + post <= max_param_sum, indexed [pre][post], from one sweep per
+// pentagon edge and direction
+std::vector<std::vector<std::vector<b_expansion_candidate>>> find_b_candidates_up_to(const dual_fullerene& G,
+    int max_param_sum);
+
 std::vector<std::unique_ptr<base_expansion>> find_b_expansions(dual_fullerene& G,
     int length_pre_bend,
     int length_post_bend);
+// find_b_expansions for every split with pre + post <= max_param_sum, by sum and then by pre
+std::vector<std::unique_ptr<base_expansion>> find_b_expansions_up_to(dual_fullerene& G, int max_param_sum);
 
 class b_expansion : public base_expansion {
     b_expansion_candidate cand_;
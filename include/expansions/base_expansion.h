@@ -1,6 +1,8 @@
 ﻿#ifndef BASE_EXPANSION_H
 #define BASE_EXPANSION_H
 #include <fullerene/dual_fullerene.h>
+#include <memory>
+#include <vector>
 
 bool patch_nodes_unique(const std::vector<int>& path, const std::vector<int>& parallel_path);
 
@@ -19,8 +19,12 @@ void build_l_rails(const dual_fullerene& G,
     std::vector<int>& parallel_path);
 
 std::vector<l_expansion_candidate> find_l_candidates(const dual_fullerene& G, int length);
+// the candidates of every length up to max_length, indexed by length, from one walk per pentagon edge and direction
+std::vector<std::vector<l_expansion_candidate>> find_l_candidates_up_to(const dual_fullerene& G, int max_length);
 
 std::vector<std::unique_ptr<base_expansion>> find_l_expansions(dual_fullerene& G, int length);
+// find_l_expansions for the lengths 0..max_length, shortest first
+std::vector<std::unique_ptr<base_expansion>> find_l_expansions_up_to(dual_fullerene& G, int max_length);
 
 class l_expansion final : public base_expansion {
     l_expansion_candidate cand_;
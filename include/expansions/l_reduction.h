@@ -21,6 +21,7 @@ find_l_reductions(const dual_fullerene& G, int size, int skip_pent, int skip_ind
 
 
 bool has_L0_pair_pent_distance_gt4(const dual_fullerene& G);
+bool has_L0_pair_pent_distance_gt4(reduction_catalogue& reductions);
 
 
 #endif
@@ -0,0 +1,83 @@
+#ifndef REDUCTION_CATALOGUE_H
+#define REDUCTION_CATALOGUE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <fullerene/dual_fullerene.h>
+#include <expansions/base_reduction.h>
+#include <expansions/b_reduction.h>
+#include <expansions/l_reduction.h>
+
+// every L and B reduction whose first edge leaves `pentagon` and whose x0 lies in [min_x0, max_x0], appended to l
+// and b. One walk along the straight ray of each edge and direction finds the L reduction at its first pentagon
+// and every B reduction bending off it. For each size the reductions come in find_l_reductions' and
+// find_b_reductions' order.
+void find_reductions_at(const dual_fullerene& G, unsigned int pentagon, int min_x0, int max_x0,
+    std::vector<l_reduction>& l, std::vector<b_reduction>& b);
+
+// The L and B reductions of one graph, enumerated per pentagon on first use and then shared by
+// everything that asks again while the graph is unchanged: is_canonical, has_L0_pair_pent_distance_gt4 and
+// limit_by_reduction_distances all query the same catalogue for a child of the search. Whoever changes the
+// graph calls reset(); the storage is kept for the next graph.
+//
+// A reduction of x0 reads no vertex further than x0 + 1 edges from its first pentagon. So a child that only
+// differs from its parent in a small patch keeps the parent's reductions at every pentagon far enough from the
+// patch: reset(parent, mark, max_x0) takes those from the parent's catalogue and enumerates only the rest.
+class reduction_catalogue {
+    static constexpr std::size_t PENTAGONS = 12;
+
+    // the reductions leaving one pentagon
+    struct bucket {
+        // x0 up to which they were enumerated since the last reset, -1 for none
+        int depth = -1;
+        // by x0
+        std::vector<std::vector<l_reduction>> l;
+        // by x0, then by pre bend length
+        std::vector<std::vector<std::vector<b_reduction>>> b;
+    };
+
+    const dual_fullerene& G_;
+    std::array<bucket, PENTAGONS> buckets_;
+    // the catalogue of the graph this one was derived from, and per pentagon the distance to the patch that
+    // changed since, capped at one more than the reach of the largest x0 asked for
+    reduction_catalogue* base_ = nullptr;
+    std::array<std::uint32_t, PENTAGONS> patch_distance_{};
+
+    // find_reductions_at() fills these before they are sorted into a bucket
+    std::vector<l_reduction> found_l_;
+    std::vector<b_reduction> found_b_;
+    // l_reductions() and b_reductions() gather the buckets here
+    std::vector<l_reduction> l_all_;
+    std::vector<b_reduction> b_all_;
+    std::vector<std::uint32_t> distance_;
+    std::vector<std::uint32_t> queue_;
+
+    // the bucket of a pentagon, enumerated to at least x0
+    const bucket& bucket_(unsigned int pentagon, int x0);
+
+public:
+    explicit reduction_catalogue(const dual_fullerene& G) : G_(G) {}
+
+    [[nodiscard]] const dual_fullerene& graph() const noexcept { return G_; }
+    void reset();
+    // the graph was changed since `base`, a catalogue of the same graph object, described it: by the mutations
+    // journaled after `mark`. base has to stay valid for the graph as it was at the mark for as long as this
+    // catalogue is used, and must not be derived itself. Queries up to max_x0 reuse base's buckets far from
+    // the change.
+    void reset(reduction_catalogue& base, std::size_t mark, int max_x0);
+
+    // both return storage that the next call overwrites
+    [[nodiscard]] const std::vector<l_reduction>& l_reductions(int size);
+    [[nodiscard]] const std::vector<b_reduction>& b_reductions(int length_pre_bend, int length_post_bend);
+    [[nodiscard]] bool has_reductions(int x0);
+
+    // appends the reductions of x0, the L reductions first and then the B reductions by length before the bend,
+    // leaving out the one at (skip_pent, skip_index, skip_clockwise): an L reduction if skip_l1 is negative,
+    // else a B reduction bent after skip_l1
+    void collect(int x0, int skip_pent, int skip_index, bool skip_clockwise, int skip_l1,
+        std::vector<const base_reduction*>& out);
+};
+
+#endif
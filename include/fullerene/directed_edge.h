@@ -1,29 +1,24 @@
 ﻿#ifndef DIRECTED_EDGE_H
 #define DIRECTED_EDGE_H
-#include <memory>
-
-class base_node;
+#include <climits>
+#include <cstdint>
 
+// An edge counts as marked when its stamp equals the owning graph's current mark epoch.
 struct edge_data {
-    bool marked = false;
+    std::uint32_t mark_epoch = 0;
     unsigned int rhs_face_index = UINT_MAX;
+    std::uint8_t rhs_face_position = 0;  // position of the edge in the trace of its rhs face
 };
 
+// A directed edge is a (vertex, rotation slot) pair; navigation goes through the owning dual_fullerene.
 struct directed_edge {
-    std::shared_ptr<base_node> from;
-    std::size_t index;
+    std::uint32_t from;
+    std::uint32_t index;
 
-    directed_edge() : index(UINT_MAX) {};
-    directed_edge(std::shared_ptr<base_node> from, const std::size_t index) : from(std::move(from)), index(index) {}
+    directed_edge() : from(UINT32_MAX), index(UINT32_MAX) {};
+    directed_edge(const std::uint32_t from, const std::uint32_t index) : from(from), index(index) {}
 
-    [[nodiscard]] std::shared_ptr<base_node> to() const;
-    [[nodiscard]] directed_edge inverse() const;
-    [[nodiscard]] directed_edge next_around(unsigned int times = 1) const;
-    [[nodiscard]] directed_edge prev_around(unsigned int times = 1) const;
-    [[nodiscard]] directed_edge left_turn(unsigned int which = 1) const;
-    [[nodiscard]] directed_edge right_turn(unsigned int which = 1) const;
-    [[nodiscard]] edge_data& data() const;
-    void change_destination(const std::shared_ptr<base_node> &destination) const;
+    [[nodiscard]] bool operator==(const directed_edge& other) const = default;
 };
 
 #endif //DIRECTED_EDGE_H
@@ -1,41 +1,183 @@
 ﻿#ifndef DUAL_FULLERENE_H
 #define DUAL_FULLERENE_H
-#include <fullerene/base_node.h>
+#include <fullerene/directed_edge.h>
 #include <fullerene/fullerene.h>
-#include <memory>
+#include <fullerene/fullerene_id.h>
+#include <array>
+#include <cstdint>
 #include <vector>
 
+enum class node_type {
+    NODE_5,
+    NODE_6,
+};
+
 class dual_fullerene {
-    std::vector<std::shared_ptr<node_5>> nodes_5;
-    std::vector<std::shared_ptr<node_6>> nodes_6;
+public:
+    static constexpr std::size_t MAX_DEGREE = 6;
+    static constexpr std::uint32_t NO_NEIGHBOR = UINT32_MAX;
+    static constexpr std::uint8_t NO_SLOT = UINT8_MAX;
+
+    // popped vertices leave their rows' capacity behind, so re-adding a vertex is allocation free. A vertex
+    // counts as recycled when it takes a row some earlier vertex was popped from, as fresh when its row was
+    // never held before (whether or not reserve() set its capacity aside).
+    struct storage_stats {
+        std::size_t recycled_vertices = 0;
+        std::size_t fresh_vertices = 0;
+    };
+
+    // the rotation system and ids of a graph, enough to rebuild it elsewhere, e.g. on an output thread
+    struct snapshot {
+        std::vector<std::array<std::uint32_t, MAX_DEGREE>> rotations;
+        std::vector<std::uint8_t> degrees;
+        std::vector<node_type> types;
+        fullerene_id id;
+        fullerene_id parent_id;
+    };
+
+private:
+    // rotation systems of all vertices, indexed by vertex id. Ids are dense (pentagons 0..11, hexagons
+    // in creation order) and hexagons are only ever removed from the back, so every lookup is direct.
+    std::vector<std::array<std::uint32_t, MAX_DEGREE>> rotations_;
+    // slot of the reverse edge in the target's rotation, kept in sync by the mutation primitives
+    std::vector<std::array<std::uint8_t, MAX_DEGREE>> inverse_slots_;
+    std::vector<std::uint8_t> degrees_;
+    std::vector<node_type> types_;
+    mutable std::vector<std::array<edge_data, MAX_DEGREE>> edge_data_;
+    mutable std::uint32_t edge_epoch_ = 1;
 
-    std::string id;
-    std::vector<std::string> construction_path;
+    std::vector<unsigned int> nodes_5;
+    std::vector<unsigned int> nodes_6;
+
+    fullerene_id id;
+    // ids from the first registered ancestor down to this graph
+    std::vector<fullerene_id> construction_path;
+
+    // undo log of row writes and vertex additions/removals, recorded only while a checkpoint is open.
+    // A row is logged once per checkpoint: row_stamps_ holds the serial of the checkpoint that last logged it.
+    // Serials are 64 bit, a search opens far too few checkpoints for them to wrap and make a stale stamp current.
+    enum class journal_op : std::uint8_t {
+        ROW,
+        ADD_VERTEX,
+        POP_VERTEX,
+    };
+    struct journal_entry {
+        journal_op op;
+        node_type type;
+        std::uint8_t degree;
+        std::uint32_t v;
+        std::array<std::uint32_t, MAX_DEGREE> rotation;
+    };
+    std::vector<journal_entry> journal_;
+    std::vector<std::uint64_t> row_stamps_;
+    std::vector<std::uint64_t> checkpoint_serials_;
+    std::uint64_t next_serial_ = 0;
+    std::vector<unsigned int> restored_rows_;
+
+    storage_stats storage_stats_;
+    // the most rows the graph has held at once
+    std::size_t peak_rows_ = 0;
+
+    [[nodiscard]] std::size_t slot_of_(unsigned int v, unsigned int n) const;
+    void insert_neighbor_at_(unsigned int v, std::size_t index, unsigned int n);
+    void erase_neighbor_at_(unsigned int v, std::size_t index);
+    void refresh_inverse_slot_(unsigned int v, std::size_t index);
+    void refresh_inverse_row_(unsigned int v);
+    int push_vertex_(node_type type, std::size_t degree);
+    unsigned int append_vertex_(node_type type, std::size_t degree);
+    void pop_vertex_();
+    void journal_row_(unsigned int v);
 
 public:
     explicit dual_fullerene(const std::vector<std::vector<unsigned int>>& adjacency);
 
-    [[nodiscard]] const std::vector<std::shared_ptr<node_5>>& get_nodes_5() const noexcept { return nodes_5; }
-    [[nodiscard]] const std::vector<std::shared_ptr<node_6>>& get_nodes_6() const noexcept { return nodes_6; }
-    [[nodiscard]] std::size_t total_nodes() const noexcept { return nodes_5.size() + nodes_6.size(); }
+    [[nodiscard]] const std::vector<unsigned int>& get_nodes_5() const noexcept { return nodes_5; }
+    [[nodiscard]] const std::vector<unsigned int>& get_nodes_6() const noexcept { return nodes_6; }
+    [[nodiscard]] std::size_t total_nodes() const noexcept { return rotations_.size(); }
+    [[nodiscard]] const storage_stats& get_storage_stats() const noexcept { return storage_stats_; }
+    [[nodiscard]] const fullerene_id& get_id() const noexcept { return id; }
+    [[nodiscard]] const fullerene_id& get_parent_id() const noexcept;
     [[nodiscard]] fullerene to_primal() const;
-    [[nodiscard]] std::shared_ptr<base_node> get_node(unsigned int id) const;
+    // refills a caller-owned fullerene, reusing its storage across calls
+    void to_primal_into(fullerene& out) const;
+    // sets only the ids of a primal built earlier, e.g. before this graph was registered
+    void copy_ids_into(fullerene& out) const;
     [[nodiscard]] bool is_ipr() const;
+    // whether every two pentagons are at least `distance` edges apart in the dual; IPR is distance 2
+    [[nodiscard]] bool has_pentagon_distance(unsigned int distance) const;
     template<typename F>
     void for_each_node(F&& f) const {
-        for (const auto& node : nodes_5) f(node);
-        for (const auto& node : nodes_6) f(node);
+        for (const auto node : nodes_5) f(node);
+        for (const auto node : nodes_6) f(node);
     }
+
+    // vertex queries
+    [[nodiscard]] std::size_t degree(const unsigned int v) const { return degrees_[v]; }
+    [[nodiscard]] node_type type(const unsigned int v) const { return types_[v]; }
+    [[nodiscard]] unsigned int neighbor_at(const unsigned int v, const std::size_t index) const { return rotations_[v][index]; }
+    [[nodiscard]] bool is_neighbor_of(unsigned int v, unsigned int n) const;
+    [[nodiscard]] directed_edge get_edge(unsigned int v, std::size_t index) const;
+    [[nodiscard]] directed_edge get_edge_to(unsigned int v, unsigned int n) const;
+
+    // directed edge navigation
+    [[nodiscard]] unsigned int to(const directed_edge e) const { return rotations_[e.from][e.index]; }
+    [[nodiscard]] directed_edge inverse(const directed_edge e) const {
+        return { rotations_[e.from][e.index], inverse_slots_[e.from][e.index] };
+    }
+    [[nodiscard]] directed_edge next_around(const directed_edge e, const unsigned int times = 1) const {
+        return { e.from, static_cast<std::uint32_t>((e.index + times) % degrees_[e.from]) };
+    }
+    [[nodiscard]] directed_edge prev_around(const directed_edge e, const unsigned int times = 1) const {
+        const std::uint32_t d = degrees_[e.from];
+        return { e.from, (e.index + d - times % d) % d };
+    }
+    [[nodiscard]] directed_edge left_turn(const directed_edge e, const unsigned int which = 1) const {
+        return next_around(inverse(e), which);
+    }
+    [[nodiscard]] directed_edge right_turn(const directed_edge e, const unsigned int which = 1) const {
+        return prev_around(inverse(e), which);
+    }
+    [[nodiscard]] edge_data& data(const directed_edge e) const { return edge_data_[e.from][e.index]; }
+    [[nodiscard]] bool is_marked(const directed_edge e) const { return data(e).mark_epoch == edge_epoch_; }
+    void mark(const directed_edge e) const { data(e).mark_epoch = edge_epoch_; }
+
+    // mutation primitives
+    // unmarks every edge by starting a new mark epoch; only sweeps the stamps when the epoch wraps around
     void clear_all_edge_data() const;
+    void reserve(std::size_t vertices);
     int add_vertex(node_type type);
+    int add_sized_vertex(node_type type);
+    void add_neighbor(int v, int n);
     void add_neighbor_after(int v, int after, int v2);
     void add_neighbor_before(int v, int before, int v2);
+    void set_neighbor_at(int v, std::size_t index, int n);
+    void remove_neighbor(int v, int n);
     void remove_edge(int v1, int v2);
     void replace_neighbor(int v, int old_n, int new_n);
     void move_neighborhood(int from, int to);
-    void add_node(const std::shared_ptr<node_6>& new_node);
+    void clear_neighbors(int v);
     void pop_last_node6();
-    void register_id();
+
+    // journaling: every mutation after checkpoint() is undone, newest first, by rollback(mark)
+    [[nodiscard]] std::size_t checkpoint();
+    void rollback(std::size_t mark);
+    // forgets all open checkpoints, e.g. for a copy that continues on its own
+    void clear_journal();
+    // calls f(v) for every vertex whose row was written, or that was added or removed, since checkpoint()
+    // returned `mark`; a vertex may come up more than once and removed ones may be past total_nodes()
+    template<typename F>
+    void for_each_changed_since(const std::size_t mark, F&& f) const {
+        for (std::size_t i = mark; i < journal_.size(); ++i) f(journal_[i].v);
+    }
+
+    // scoped ids are numbered separately from unscoped ones, see id_registry
+    void register_id(std::uint32_t scope = fullerene_id::NO_SCOPE);
+
+    // both reuse the storage they fill; a loaded graph has no journal and keeps only its id and parent id
+    void save_snapshot(snapshot& out) const;
+    void load_snapshot(const snapshot& in);
+    // takes an id assigned elsewhere (e.g. read back from a stream) instead of registering a new one
+    void assign_id(const fullerene_id& new_id);
     void reduce_id();
 };
 
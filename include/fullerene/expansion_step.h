@@ -0,0 +1,26 @@
+#ifndef EXPANSION_STEP_H
+#define EXPANSION_STEP_H
+#include <fullerene/directed_edge.h>
+#include <cstdint>
+
+enum class step_type : std::uint8_t {
+    SEED_C20,
+    SEED_C28,
+    SEED_C30,
+    F,
+    L,
+    B,
+};
+
+// How an emitted graph was obtained: a base fullerene, or one expansion applied to its parent's dual.
+// start is the candidate's start edge in the parent (for F only start.from, the expanded pentagon, is used);
+// an L expansion keeps its length in length_pre_bend.
+struct expansion_step {
+    step_type type = step_type::SEED_C20;
+    directed_edge start{};
+    bool clockwise = false;
+    int length_pre_bend = 0;
+    int length_post_bend = 0;
+};
+
+#endif //EXPANSION_STEP_H
@@ -1,20 +1,31 @@
 ﻿#ifndef FULLERENE_H
 #define FULLERENE_H
 #include <array>
+#include <cstdint>
+#include <fullerene/fullerene_id.h>
 #include <vector>
+#include <span>
 #include <string>
 #include <cmath>
 
+class dual_fullerene;
+
+// Also serves as the reusable output buffer of dual_fullerene::to_primal_into, which refills it in place.
 class fullerene {
-    std::string id_;
-    std::string parent_id_;
-    bool is_ipr_;
+    fullerene_id id_;
+    fullerene_id parent_id_;
+    bool is_ipr_ = false;
     std::vector<std::array<unsigned int, 3>> adjacency_;
-    std::array<unsigned int, 5> outer_face_nodes_;
+    std::array<unsigned int, 5> outer_face_nodes_{};
+    // 1 where an adjacency row lists its neighbors against the common orientation (empty if unknown)
+    std::vector<std::uint8_t> reversed_rows_;
+
+    friend class dual_fullerene;
 
 public:
-    explicit fullerene(const std::string& id,
-                        const std::string& parent_id,
+    fullerene() = default;
+    explicit fullerene(const fullerene_id& id,
+                        const fullerene_id& parent_id,
                         const bool is_ipr,
                         const std::vector<std::array<unsigned int, 3>>& adjacency,
                         const std::array<unsigned int, 5> &outer_face):
@@ -24,11 +35,25 @@ public:
                         adjacency_(adjacency),
                         outer_face_nodes_(outer_face) {};
 
-    [[nodiscard]] std::vector<std::array<unsigned int, 3>> get_adjacency() const { return adjacency_; }
+    [[nodiscard]] const std::vector<std::array<unsigned int, 3>>& get_adjacency() const { return adjacency_; }
+    [[nodiscard]] std::span<const std::array<unsigned int, 3>> get_adjacency_view() const noexcept { return adjacency_; }
     [[nodiscard]] size_t get_size() const { return adjacency_.size(); }
     [[nodiscard]] std::array<unsigned int, 5> get_outer_face_nodes() const { return outer_face_nodes_; }
+    // the neighbors of v in one consistent rotation order for all vertices, as needed by planar_code
+    [[nodiscard]] std::array<unsigned int, 3> get_rotation(std::size_t v) const {
+        const auto& row = adjacency_[v];
+        if (reversed_rows_.empty() || !reversed_rows_[v]) {
+            return row;
+        }
+        return { row[0], row[2], row[1] };
+    }
     [[nodiscard]] std::string write_all() const noexcept;
-    std::string get_parent_id() const { return parent_id_; }
+    // text record formatting without allocations: write_text needs at most max_text_size() bytes at out
+    [[nodiscard]] std::size_t max_text_size() const noexcept;
+    char* write_text(char* out) const noexcept;
+    [[nodiscard]] const fullerene_id& get_parent_id() const noexcept { return parent_id_; }
+    [[nodiscard]] const fullerene_id& get_id() const noexcept { return id_; }
+    [[nodiscard]] bool is_ipr() const noexcept { return is_ipr_; }
     friend std::ostream &operator<<(std::ostream &os, const fullerene &f);
 };
 
@@ -0,0 +1,30 @@
+#ifndef FULLERENE_ID_H
+#define FULLERENE_ID_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The id of a generated isomer: its atom count and its ordinal among the isomers of that size, numbered on
+// their own per scope (e.g. the slice of a split search). Ids stay integers until output, which writes them
+// as "<size>:<ordinal>" or "<size>:<scope>/<ordinal>". The parent of the base fullerenes is BASE, size 0.
+struct fullerene_id {
+    static constexpr std::uint32_t NO_SCOPE = UINT32_MAX;
+    // "<size>:<scope>/<ordinal>" with every number at its longest
+    static constexpr std::size_t MAX_TEXT_SIZE = 10 + 1 + 10 + 1 + 20;
+
+    std::uint32_t size = 0;
+    std::uint32_t scope = NO_SCOPE;
+    std::uint64_t ordinal = 0;
+
+    [[nodiscard]] bool is_base() const noexcept { return size == 0; }
+    [[nodiscard]] bool operator==(const fullerene_id& other) const = default;
+
+    // writes at most MAX_TEXT_SIZE bytes
+    char* write_text(char* out) const noexcept;
+    [[nodiscard]] std::string to_string() const;
+    // returns false if text is not an id
+    static bool parse(std::string_view text, fullerene_id& id);
+};
+
+#endif //FULLERENE_ID_H
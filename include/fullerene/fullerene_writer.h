@@ -0,0 +1,85 @@
+#ifndef FULLERENE_WRITER_H
+#define FULLERENE_WRITER_H
+#include <fullerene/expansion_step.h>
+#include <fullerene/fullerene.h>
+#include <fullerene/fullerene_id.h>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// TEXT: the fullerene::write_all records.
+// BINARY: stream header ">>fullerene_binary<<", then per record a little-endian uint16 size, a flag byte
+//   (bit 0 IPR, bit 1 two-byte indices), the id and the parent id as uint8 length + bytes, the 5 outer face
+//   nodes and 3 neighbors per vertex. Indices are uint8 while size <= 255 and little-endian uint16 otherwise.
+// PLANAR_CODE: plantri's planar_code with header ">>planar_code le<<" (1-based, rotation order, 0-terminated).
+// DELTA: header ">>fullerene_delta<<" and one line per isomer, "<id> <parent id> <step>", where the step is
+//   C20, C28 or C30 for base fullerenes, "F <pentagon>", "L <from> <slot> <clockwise> <length>" or
+//   "B <from> <slot> <clockwise> <pre bend> <post bend>"; delta_decoder rebuilds full graphs from it.
+// COUNT: no records, only the number of isomers and IPR isomers per atom count; write_counts prints the table
+//   "<atoms> <isomers> <ipr isomers>". Generators count straight from the dual graphs and skip ids.
+enum class output_format {
+    TEXT,
+    BINARY,
+    PLANAR_CODE,
+    DELTA,
+    COUNT,
+};
+
+// maps the command line names text, binary, planar_code, delta and count to a format
+bool parse_output_format(std::string_view name, output_format& format);
+// the command line name of a format
+std::string_view output_format_name(output_format format);
+
+// a stream that already holds `bytes` bytes of output in the same format, header included
+struct continued_stream {
+    std::uint64_t bytes;
+};
+
+struct isomer_count {
+    std::uint64_t isomers = 0;
+    std::uint64_t ipr = 0;
+};
+
+// Buffers records and hands them to the stream in large blocks instead of flushing every record.
+class fullerene_writer {
+    std::ostream& os_;
+    output_format format_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::uint64_t flushed_ = 0;
+    // indexed by atom count
+    std::vector<isomer_count> counts_;
+
+    [[nodiscard]] std::size_t max_record_size(const fullerene& f) const noexcept;
+    void reserve_(std::size_t bytes);
+
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    explicit fullerene_writer(std::ostream& os, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+    fullerene_writer(std::ostream& os, output_format format, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+    // appends to an earlier stream, e.g. when resuming a run, without writing the header again
+    fullerene_writer(std::ostream& os, output_format format, continued_stream continued,
+        std::size_t block_size = DEFAULT_BLOCK_SIZE);
+    ~fullerene_writer();
+
+    fullerene_writer(const fullerene_writer&) = delete;
+    fullerene_writer& operator=(const fullerene_writer&) = delete;
+
+    [[nodiscard]] output_format get_format() const noexcept { return format_; }
+    // bytes of the stream so far, including the ones still buffered
+    [[nodiscard]] std::uint64_t bytes_written() const noexcept { return flushed_ + used_; }
+
+    void write(const fullerene& f);
+    void write_step(const fullerene_id& id, const fullerene_id& parent_id, const expansion_step& step);
+    // tallies an isomer without writing it; write() does the same for full fullerenes on a COUNT stream
+    void count(std::size_t atoms, bool ipr);
+    [[nodiscard]] const std::vector<isomer_count>& get_counts() const noexcept { return counts_; }
+    // appends the table of the isomers counted so far, with a closing total line
+    void write_counts();
+    void flush();
+};
+
+#endif //FULLERENE_WRITER_H
@@ -0,0 +1,27 @@
+#ifndef BACKOFF_H
+#define BACKOFF_H
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+// How the threads of a search wait for each other without a condition variable: a waiter first yields, so
+// short waits stay cheap, and sleeps once the wait has gone on for a while, e.g. in the narrow top of the tree.
+struct backoff {
+    static constexpr std::size_t SPIN_ROUNDS = 64;
+    static constexpr std::chrono::microseconds SLEEP{ 100 };
+
+    std::size_t idle_rounds = 0;
+
+    void pause() {
+        if (++idle_rounds < SPIN_ROUNDS) {
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(SLEEP);
+        }
+    }
+    // the awaited progress came, the next wait starts short again
+    void reset() noexcept { idle_rounds = 0; }
+};
+
+#endif //BACKOFF_H
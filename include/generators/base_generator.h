@@ -1,19 +1,137 @@
 ﻿#ifndef BASE_GENERATOR_H
 #define BASE_GENERATOR_H
 #include <cstddef>
+#include <cstdint>
+#include <fullerene/construct.h>
 #include <fullerene/dual_fullerene.h>
-#include <iostream>
+#include <fullerene/expansion_step.h>
+#include <fullerene/fullerene_writer.h>
+#include <generators/emit_pipeline.h>
 #include <map>
+#include <mutex>
+#include <optional>
 
 class base_generator {
+    fullerene_writer& out_;
+    // emit_snapshot rebuilds its graphs here, under the lock
+    fullerene primal_;
+    std::mutex emit_mutex_;
+    // graphs outside the size range or with closer pentagons are searched and registered but neither
+    // written nor counted
+    std::size_t min_emitted_size_ = 0;
+    std::size_t max_emitted_size_ = SIZE_MAX;
+    unsigned int min_pentagon_distance_ = 1;
+    emit_pipeline* pipeline_ = nullptr;
+    // rebuilds the snapshots of emit_snapshot when there is no pipeline to do it
+    std::optional<dual_fullerene> loaded_;
+
 public:
+    explicit base_generator(fullerene_writer& out) : out_(out) {}
     virtual ~base_generator() = default;
     virtual void generate(std::size_t up_to) = 0;
-    virtual void register_and_emit(dual_fullerene& G) {
-        G.register_id();
-        auto P = G.to_primal();
-        std::cout << P << std::flush;
+    void set_emitted_sizes(const std::size_t min_size, const std::size_t max_size) {
+        min_emitted_size_ = min_size;
+        max_emitted_size_ = max_size;
+    }
+    // 2 writes the IPR isomers only
+    void set_min_pentagon_distance(const unsigned int distance) { min_pentagon_distance_ = distance; }
+    // hands the graphs to an output thread instead of writing them on the search thread
+    void set_pipeline(emit_pipeline* pipeline) { pipeline_ = pipeline; }
+    virtual void register_and_emit(dual_fullerene& G, const expansion_step& step, std::uint32_t id_scope = fullerene_id::NO_SCOPE) {
+        const bool written = is_written(G);
+        // each thread builds its primal graphs before queueing for the writer; the ids are filled in once
+        // registered
+        thread_local fullerene primal;
+        const auto format = out_.get_format();
+        const bool writes_primal = written && pipeline_ == nullptr && format != output_format::COUNT
+            && format != output_format::DELTA;
+        if (writes_primal) {
+            G.to_primal_into(primal);
+        }
+
+        // ids are handed out in output order, so registration and writing happen under one lock
+        std::lock_guard lock(emit_mutex_);
+        if (!written) {
+            // ids stay those of a full run, so a graph keeps its id whatever range is written
+            if (!counts_only()) {
+                G.register_id(id_scope);
+            }
+            return;
+        }
+        if (format == output_format::COUNT) {
+            // a dual with V vertices is a fullerene with 2V - 4 atoms
+            out_.count(2 * G.total_nodes() - 4, G.is_ipr());
+            return;
+        }
+        G.register_id(id_scope);
+        if (pipeline_ != nullptr) {
+            pipeline_->push(G, step);
+            return;
+        }
+        if (format == output_format::DELTA) {
+            out_.write_step(G.get_id(), G.get_parent_id(), step);
+            return;
+        }
+        G.copy_ids_into(primal);
+        out_.write(primal);
+    }
+
+protected:
+    [[nodiscard]] fullerene_writer& writer() noexcept { return out_; }
+
+    // whether G is within the size range and pentagon distance the run writes
+    [[nodiscard]] bool is_written(const dual_fullerene& G) const {
+        // a dual with V vertices is a fullerene with 2V - 4 atoms
+        const std::size_t atoms = 2 * G.total_nodes() - 4;
+        return atoms >= min_emitted_size_ && atoms <= max_emitted_size_ && G.has_pentagon_distance(min_pentagon_distance_);
+    }
+
+    // writes a graph saved earlier, e.g. by a search thread whose output is put in order afterwards; the
+    // snapshot carries the ids to write. Its storage may be swapped with a pipeline slot's.
+    void emit_snapshot(dual_fullerene::snapshot& graph, const expansion_step& step) {
+        std::lock_guard lock(emit_mutex_);
+        if (pipeline_ != nullptr) {
+            pipeline_->push(graph, step);
+            return;
+        }
+        if (out_.get_format() == output_format::DELTA) {
+            out_.write_step(graph.id, graph.parent_id, step);
+            return;
+        }
+        if (!loaded_) {
+            loaded_.emplace(create_c20_fullerene());
+        }
+        loaded_->load_snapshot(graph);
+        loaded_->to_primal_into(primal_);
+        out_.write(primal_);
     }
+    // waits until the pipeline, if any, has handed everything to the writer, so the writer can be used directly
+    void drain_output() {
+        if (pipeline_ != nullptr) {
+            pipeline_->drain();
+        }
+    }
+
+    // gives G the id it would have been emitted with, for graphs another run is responsible for writing
+    void register_only(dual_fullerene& G, const std::uint32_t id_scope = fullerene_id::NO_SCOPE) {
+        if (counts_only()) {
+            return;
+        }
+        std::lock_guard lock(emit_mutex_);
+        G.register_id(id_scope);
+    }
+
+    // drops the id G was registered with once its subtree is done
+    void release_id(dual_fullerene& G) const {
+        if (!counts_only()) {
+            G.reduce_id();
+        }
+    }
+
+    [[nodiscard]] unsigned int min_pentagon_distance() const noexcept { return min_pentagon_distance_; }
+
+    // counting runs never register ids
+    [[nodiscard]] bool counts_only() const noexcept { return out_.get_format() == output_format::COUNT; }
 };
 
 #endif //BASE_GENERATOR_H
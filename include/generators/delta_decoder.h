@@ -0,0 +1,33 @@
+#ifndef DELTA_DECODER_H
+#define DELTA_DECODER_H
+#include <fullerene/dual_fullerene.h>
+#include <fullerene/expansion_step.h>
+#include <fullerene/fullerene_id.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+struct delta_record {
+    fullerene_id id;
+    fullerene_id parent_id;
+    expansion_step step;
+};
+
+// Consumes the ">>fullerene_delta<<" stream header; returns false if the stream doesn't start with it.
+bool read_delta_header(std::istream& is);
+
+// Reads the next record; returns false at the end of the input and throws std::runtime_error on malformed records.
+bool read_delta_record(std::istream& is, delta_record& record);
+
+// Rebuilds full dual graphs from records given in emission order. Generation is a depth-first search, so the
+// parent of every record is the previous record or one of its ancestors; only that chain of ancestors is kept.
+class delta_decoder {
+    std::vector<dual_fullerene> ancestors_;
+
+    static void apply_step(dual_fullerene& G, const expansion_step& step);
+
+public:
+    const dual_fullerene& decode(const delta_record& record);
+};
+
+#endif //DELTA_DECODER_H
@@ -0,0 +1,65 @@
+#ifndef EMIT_PIPELINE_H
+#define EMIT_PIPELINE_H
+#include <fullerene/dual_fullerene.h>
+#include <fullerene/expansion_step.h>
+#include <fullerene/fullerene_writer.h>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Moves serialization off the search: push copies the rotation system of a graph into a slot of a bounded
+// single-producer ring, and one output thread rebuilds the primal, formats it and writes it, in push order.
+// The search only waits when the ring is full. Pushes have to be serialized by the caller, which
+// base_generator's emit lock already does. While the pipeline runs, only its thread touches the writer;
+// drain() hands the writer back, e.g. for a flush.
+class emit_pipeline {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    struct stats {
+        std::size_t records = 0;
+        // pushes that found the ring full and had to wait for the output thread
+        std::size_t full_waits = 0;
+    };
+
+private:
+    struct slot {
+        dual_fullerene::snapshot graph;
+        expansion_step step;
+    };
+
+    fullerene_writer& out_;
+    std::vector<slot> slots_;
+    // slots are numbered ever increasing; slot i lives at slots_[i % capacity]
+    std::atomic<std::size_t> head_{ 0 };  // next slot to write out
+    std::atomic<std::size_t> tail_{ 0 };  // next slot to fill
+    std::atomic<bool> stopping_{ false };
+    std::atomic<bool> failed_{ false };
+    std::exception_ptr error_;
+    stats stats_;
+    std::thread thread_;
+
+    void run_();
+    void rethrow_if_failed_();
+    // waits for a free slot; publish_slot_ hands it to the output thread once it is filled
+    slot& acquire_slot_();
+    void publish_slot_();
+
+public:
+    explicit emit_pipeline(fullerene_writer& out, std::size_t capacity = DEFAULT_CAPACITY);
+    ~emit_pipeline();
+
+    emit_pipeline(const emit_pipeline&) = delete;
+    emit_pipeline& operator=(const emit_pipeline&) = delete;
+
+    void push(const dual_fullerene& G, const expansion_step& step);
+    // the same for a graph saved earlier; swaps storage with the slot instead of copying
+    void push(dual_fullerene::snapshot& graph, const expansion_step& step);
+    // waits until every pushed graph has been handed to the writer; rethrows what the output thread threw
+    void drain();
+    [[nodiscard]] const stats& get_stats() const noexcept { return stats_; }
+};
+
+#endif //EMIT_PIPELINE_H
@@ -3,8 +3,19 @@
 #include <generators/base_generator.h>
 
 class f_expansion_generator final : base_generator {
+    bool written_ = true;
+
+    void emit_(dual_fullerene& G, const expansion_step& step);
+
 public:
-    f_expansion_generator() = default;
+    explicit f_expansion_generator(fullerene_writer& out) : base_generator(out) {}
+
+    using base_generator::set_emitted_sizes;
+    using base_generator::set_min_pentagon_distance;
+    using base_generator::set_pipeline;
+    // a chain that isn't written still takes its ids, so that the slices of a split search which leave the
+    // chain to another slice number their own graphs the way the full run does
+    void set_written(const bool written) { written_ = written; }
 
     void generate(std::size_t up_to) override;
 };
@@ -1,20 +1,130 @@
 #ifndef FULLERENE_GENERATOR_ID_REGISTRY_H
 #define FULLERENE_GENERATOR_ID_REGISTRY_H
+#include <fullerene/fullerene_id.h>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <deque>
 #include <map>
-#include <string>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <utility>
 
+// Hands out the ordinals of fullerene ids, counted per scope and atom count. Registering an id is one atomic
+// increment and allocates nothing once its counter exists, so searches on several threads can share the
+// registry. Counters are allocated on first use and looked up without locking afterwards: a scope's counters
+// come in blocks of doubling size, block k holding the 2^k atom counts from 2 (2^k - 1) on, so a run only pays
+// for the sizes it reaches.
 class id_registry {
-    inline static std::map<unsigned, unsigned> counters;
+public:
+    // next ordinal per (scope, atom count)
+    using counter_map = std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint64_t>;
+
+private:
+    using counter = std::atomic<std::uint64_t>;
+    // enough blocks for every half of a 32 bit atom count
+    static constexpr std::size_t BLOCKS = 32;
+
+    struct scope_counters {
+        std::uint32_t scope = fullerene_id::NO_SCOPE;
+        std::array<std::atomic<counter*>, BLOCKS> blocks{};
+        scope_counters* older = nullptr;
+    };
+
+    inline static std::mutex mutex_;
+    inline static std::deque<scope_counters> storage_;
+    inline static std::deque<std::unique_ptr<counter[]>> block_storage_;
+    // newest first; entries are only ever added, so readers walk the list without the lock
+    inline static std::atomic<scope_counters*> newest_{ nullptr };
+
+    static scope_counters* find_(const std::uint32_t scope) {
+        for (auto* counters = newest_.load(std::memory_order_acquire); counters != nullptr; counters = counters->older) {
+            if (counters->scope == scope) {
+                return counters;
+            }
+        }
+        return nullptr;
+    }
+
+    static scope_counters& counters_(const std::uint32_t scope) {
+        if (auto* counters = find_(scope)) {
+            return *counters;
+        }
+        std::lock_guard lock(mutex_);
+        // another thread may have added the scope in the meantime
+        if (auto* counters = find_(scope)) {
+            return *counters;
+        }
+        auto& counters = storage_.emplace_back();
+        counters.scope = scope;
+        counters.older = newest_.load(std::memory_order_relaxed);
+        newest_.store(&counters, std::memory_order_release);
+        return counters;
+    }
+
+    static counter& counter_(scope_counters& counters, const std::uint32_t atoms) {
+        const auto slot = static_cast<std::uint64_t>(atoms / 2) + 1;
+        const auto block = static_cast<std::size_t>(std::bit_width(slot) - 1);
+        const auto offset = slot - (std::uint64_t{ 1 } << block);
+
+        auto* counts = counters.blocks[block].load(std::memory_order_acquire);
+        if (counts == nullptr) {
+            std::lock_guard lock(mutex_);
+            counts = counters.blocks[block].load(std::memory_order_relaxed);
+            if (counts == nullptr) {
+                counts = block_storage_.emplace_back(std::make_unique<counter[]>(std::size_t{ 1 } << block)).get();
+                counters.blocks[block].store(counts, std::memory_order_release);
+            }
+        }
+        return counts[offset];
+    }
 
 public:
-    [[nodiscard]] static std::string register_id(unsigned n) {
-        const auto id = counters[n]++;
+    // ids of a scope are numbered on their own, so that runs which only share the unscoped ids (e.g. the
+    // slices of a split search) never hand out the same id twice
+    [[nodiscard]] static fullerene_id register_id(const std::uint32_t atoms, const std::uint32_t scope = fullerene_id::NO_SCOPE) {
+        const auto ordinal = counter_(counters_(scope), atoms).fetch_add(1, std::memory_order_relaxed);
+        return { atoms, scope, ordinal };
+    }
 
-        std::ostringstream ss;
+    // the counters are part of a checkpoint: a resumed run continues the numbering where it stopped.
+    // Neither call may overlap with registering ids.
+    [[nodiscard]] static counter_map get_counters() {
+        std::lock_guard lock(mutex_);
+        counter_map counters;
+        for (const auto& scope : storage_) {
+            for (std::size_t block = 0; block < BLOCKS; ++block) {
+                const auto* counts = scope.blocks[block].load(std::memory_order_relaxed);
+                if (counts == nullptr) {
+                    continue;
+                }
+                for (std::uint64_t offset = 0; offset < (std::uint64_t{ 1 } << block); ++offset) {
+                    if (const auto next = counts[offset].load(std::memory_order_relaxed); next > 0) {
+                        const auto half = (std::uint64_t{ 1 } << block) + offset - 1;
+                        counters[{ scope.scope, static_cast<std::uint32_t>(2 * half) }] = next;
+                    }
+                }
+            }
+        }
+        return counters;
+    }
 
-        ss << n << ":" << id;
-        return ss.str();
+    static void restore_counters(const counter_map& restored) {
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& scope : storage_) {
+                for (std::size_t block = 0; block < BLOCKS; ++block) {
+                    auto* counts = scope.blocks[block].load(std::memory_order_relaxed);
+                    for (std::uint64_t offset = 0; counts != nullptr && offset < (std::uint64_t{ 1 } << block); ++offset) {
+                        counts[offset].store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+        for (const auto& [key, next] : restored) {
+            counter_(counters_(key.first), key.second).store(next, std::memory_order_relaxed);
+        }
     }
 };
 
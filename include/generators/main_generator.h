@@ -1,21 +1,156 @@
-#ifndef MAIN_GENERATOR_H
+﻿#ifndef MAIN_GENERATOR_H
 #define MAIN_GENERATOR_H
 
 #include <generators/base_generator.h>
+#include <generators/reorder_buffer.h>
+#include <generators/search_checkpoint.h>
+#include <generators/work_stealing_pool.h>
 #include <fullerene/dual_fullerene.h>
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <limits>
+#include <string>
+#include <vector>
+
+// res/mod static partitioning of the search for runs that share nothing. The graphs at depth `depth` of the
+// search tree (C20 is depth 0) are numbered in dfs order; slice res searches and writes those numbered
+// res modulo mod together with their subtrees. Shallower graphs are searched by every slice and written by
+// slice 0 alone, so the slices 0..mod-1 together write every graph exactly once.
+// With AUTO_DEPTH the depth is the shallowest one where a search estimate, which every slice computes
+// identically from a fixed seed, expects enough graphs for the round robin to even out.
+struct search_split {
+    static constexpr int AUTO_DEPTH = -1;
+
+    std::size_t res = 0;
+    std::size_t mod = 1;
+    int depth = AUTO_DEPTH;
+
+    [[nodiscard]] bool enabled() const noexcept { return mod > 1; }
+};
+
+// Knuth's estimate of the search tree below C20: a probe walks down to a leaf through uniformly chosen
+// canonical children, counting each graph on its way with the product of the branching factors above it.
+// The average over the probes is unbiased for every count below, and for the time the search spends.
+struct search_estimate {
+    std::size_t probes = 0;
+    std::vector<double> graphs_per_depth;
+    // indexed by atom count
+    std::vector<double> graphs_per_size;
+    double graphs = 0;
+    // sequential search time, from the time taken to expand the probed graphs
+    double seconds = 0;
+};
+
 class main_generator final : base_generator {
 public:
-    main_generator() = default;
+    static constexpr std::uint64_t DEFAULT_ESTIMATE_SEED = 20;
+    static constexpr std::size_t DEFAULT_REORDER_WINDOW = 1 << 14;
+
+    // the bounds on the expansions tried on a graph, see dfs_
+    struct search_bounds {
+        int max_size_l;
+        int max_param_sum_b;
+        int min_reduction_size;
+    };
+
+    // threads > 1 spreads the subtrees of the search over a work-stealing pool; emission order then varies,
+    // unless the output is ordered
+    explicit main_generator(fullerene_writer& out, std::size_t threads = 1, const search_split& split = {});
+
+    using base_generator::set_emitted_sizes;
+    using base_generator::set_min_pentagon_distance;
+    using base_generator::set_pipeline;
 
     void generate(std::size_t up_to) override;
+    // makes a parallel search write the records, ids included, of a sequential one. Graphs found ahead of
+    // their turn wait in a reorder buffer; once about `window` of them wait, the threads ahead stop for the others.
+    // Delta streams need it and get the default window unless one is set.
+    void set_ordered_output(std::size_t window = DEFAULT_REORDER_WINDOW);
+    // how much the last ordered search had to buffer
+    [[nodiscard]] const reorder_stats& get_reorder_stats() const noexcept { return reorder_stats_; }
+    // writes a checkpoint to `file` whenever `interval` has passed since the last one; sequential searches only
+    void enable_checkpoints(std::string file, std::chrono::duration<double> interval);
+    // makes the next generate continue the search the checkpoint was taken of, writing only what came after it
+    void resume_from(search_checkpoint checkpoint);
+    // probes the search up to the given atom count without writing anything; probes stop at max_depth
+    [[nodiscard]] search_estimate estimate(std::size_t up_to,
+        std::size_t probes,
+        std::uint64_t seed = DEFAULT_ESTIMATE_SEED,
+        int max_depth = std::numeric_limits<int>::max());
 
 private:
-    void dfs_(dual_fullerene& G,
-        std::size_t up_to,
-        int max_size_l,
-        int max_param_sum_b,
-        int min_reduction_size);
+    // a canonical graph whose subtree is still to be searched, with the bounds dfs_ would recurse with
+    struct dfs_task {
+        dual_fullerene G;
+        search_bounds bounds;
+        int depth;
+    };
+
+    // a graph the search entered, as the reorder buffer keeps it until its turn; the id is assigned then
+    struct ordered_record {
+        int depth;
+        // false for graphs that only take up an id
+        bool written;
+        std::uint32_t scope;
+        std::uint32_t atoms;
+        expansion_step step;
+        dual_fullerene::snapshot graph;
+    };
+    using ordered_output = reorder_buffer<ordered_record, dfs_task>;
+
+    // a subtree for the pool, or with ordered output the segment holding it until a worker claims it
+    struct spawned_task {
+        std::optional<dfs_task> task;
+        std::shared_ptr<ordered_output::segment> segment;
+    };
+
+    std::size_t threads_;
+    work_stealing_pool<spawned_task>* pool_ = nullptr;
+
+    std::size_t reorder_window_ = 0;
+    ordered_output* order_ = nullptr;
+    // the segment each worker appends to
+    std::vector<ordered_output::segment*> segments_;
+    // ids of the last committed graph at each depth, after the parent id of C20
+    std::vector<fullerene_id> ordered_ids_;
+    reorder_stats reorder_stats_;
+
+    search_split split_;
+    // split_.depth, with AUTO_DEPTH resolved for the current run
+    int split_depth_ = 0;
+    // ids of the graphs a slice owns below the split depth, unique across slices
+    std::uint32_t split_scope_ = fullerene_id::NO_SCOPE;
+    // graphs reached at the split depth so far; only the thread searching the top of the tree counts them
+    std::size_t split_count_ = 0;
+
+    std::size_t up_to_ = 0;
+    std::string checkpoint_file_;
+    std::chrono::duration<double> checkpoint_interval_{};
+    std::chrono::steady_clock::time_point last_checkpoint_;
+    std::optional<search_checkpoint> resumed_;
+    // the graphs from C20 down to the one being searched, as a checkpoint records them
+    std::vector<search_checkpoint::frame> path_;
+    // what is left of the resumed path: the search walks back down it before writing anything
+    std::vector<search_checkpoint::frame> resume_;
+
+    void maybe_checkpoint_();
+    // registers G, found at the given depth, and writes it when this slice owns it. Returns false when
+    // G and its subtree belong to another slice.
+    bool enter_(dual_fullerene& G, const expansion_step& step, int depth, std::size_t worker);
+    // registers G, and writes it if `written`; with ordered output both wait for G's turn in the reorder buffer
+    void emit_(dual_fullerene& G, const expansion_step& step, int depth, std::size_t worker, bool written, std::uint32_t scope);
+    void commit_(ordered_record& record);
+    // searches a subtree forked off with ordered output, appending to the given segment
+    void run_ordered_(ordered_output::segment* segment, dfs_task& task, std::size_t worker);
+    void dfs_(dual_fullerene& G, std::size_t up_to, const search_bounds& bounds, int depth, std::size_t worker);
+    void descend_(dual_fullerene& G, std::size_t up_to, const search_bounds& bounds, int depth, std::size_t worker);
+    // applies every expansion of G within the bounds and calls visit(step, child bounds) with G turned into
+    // each canonical child in turn; G is restored afterwards
+    template<typename Visit>
+    void for_each_child_(dual_fullerene& G, std::size_t up_to, const search_bounds& bounds, Visit&& visit);
 
     static int bound_by_vertex_count_l(const dual_fullerene& G, std::size_t up_to);
     static int bound_by_vertex_count_b(const dual_fullerene& G, std::size_t up_to);
@@ -0,0 +1,193 @@
+#ifndef REORDER_BUFFER_H
+#define REORDER_BUFFER_H
+#include <generators/backoff.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+struct reorder_stats {
+    std::size_t records = 0;
+    // records that had to wait for an earlier segment before they were committed
+    std::size_t buffered = 0;
+    std::size_t peak_buffered = 0;
+    std::size_t forks = 0;
+    // appends that found the window full
+    std::size_t window_waits = 0;
+    // subtrees a blocked task ran itself because they were holding up the head
+    std::size_t helped = 0;
+};
+
+// Puts the records of subtrees searched concurrently back into the order of a sequential dfs. Every running
+// task appends to its own segment of a list kept in dfs order. Forking a subtree off closes the forking task's
+// segment and inserts two new ones behind it, one for the subtree and one for the rest of the task. Records of
+// the first open segment, the head, are committed as they arrive; the others wait until their segment becomes
+// the head. So commits see exactly the sequence a single thread would have produced.
+//
+// The window bounds the waiting records: beyond it forks stop and tasks outside the head block in
+// wait_for_room. A blocked task runs the head's subtree itself when no worker has started it yet, so the head
+// always makes progress and the buffer drains.
+template<typename Record, typename Task>
+class reorder_buffer {
+public:
+    using committer = std::function<void(Record&)>;
+
+    struct segment {
+        std::vector<Record> records;
+        // the forked subtree, until a worker claims it
+        std::optional<Task> task;
+        bool claimed = false;
+        bool closed = false;
+        std::shared_ptr<segment> next;
+    };
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<segment> head_;
+    std::size_t window_;
+    std::atomic<std::size_t> waiting_{ 0 };
+    std::atomic<bool> failed_{ false };
+    committer commit_;
+    reorder_stats stats_;
+
+    // moves the head past closed segments and commits what the new head collected in the meantime
+    void advance_() {
+        while (true) {
+            for (auto& record : head_->records) {
+                commit_(record);
+            }
+            waiting_.fetch_sub(head_->records.size(), std::memory_order_relaxed);
+            head_->records.clear();
+            if (!head_->closed || !head_->next) {
+                return;
+            }
+            head_ = head_->next;
+        }
+    }
+
+public:
+    reorder_buffer(const std::size_t window, committer commit) :
+        head_(std::make_shared<segment>()), window_(window), commit_(std::move(commit)) {}
+
+    ~reorder_buffer() {
+        // unlinks the list front to back instead of letting the shared pointers destroy it recursively
+        while (head_) {
+            head_ = std::move(head_->next);
+        }
+    }
+
+    reorder_buffer(const reorder_buffer&) = delete;
+    reorder_buffer& operator=(const reorder_buffer&) = delete;
+
+    // the segment of the task that starts the search
+    [[nodiscard]] segment* root() const noexcept { return head_.get(); }
+
+    // whether forking a subtree off keeps the waiting records within the window
+    [[nodiscard]] bool has_room() const noexcept { return waiting_.load(std::memory_order_relaxed) < window_; }
+
+    void append(segment* s, Record record) {
+        std::lock_guard lock(mutex_);
+        if (failed_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        stats_.records++;
+        if (s == head_.get()) {
+            commit_(record);
+            return;
+        }
+        s->records.push_back(std::move(record));
+        stats_.buffered++;
+        const auto waiting = waiting_.fetch_add(1, std::memory_order_relaxed) + 1;
+        stats_.peak_buffered = std::max(stats_.peak_buffered, waiting);
+    }
+
+    // closes `current` and continues the task in a new segment behind the forked subtree's; the returned
+    // segment holds the subtree until claim() hands it to a worker
+    std::shared_ptr<segment> fork(segment*& current, Task task) {
+        auto forked = std::make_shared<segment>();
+        forked->task.emplace(std::move(task));
+        auto rest = std::make_shared<segment>();
+
+        std::lock_guard lock(mutex_);
+        stats_.forks++;
+        rest->next = std::move(current->next);
+        forked->next = rest;
+        current->next = forked;
+        current->closed = true;
+        const bool was_head = current == head_.get();
+        current = rest.get();
+        if (was_head) {
+            advance_();
+        }
+        return forked;
+    }
+
+    // the subtree of a forked segment for the first caller, nothing for later ones
+    std::optional<Task> claim(const std::shared_ptr<segment>& s) {
+        std::lock_guard lock(mutex_);
+        if (s->claimed) {
+            return std::nullopt;
+        }
+        s->claimed = true;
+        return std::move(s->task);
+    }
+
+    // a task is done with its segment
+    void close(segment* s) {
+        std::lock_guard lock(mutex_);
+        s->closed = true;
+        if (s == head_.get()) {
+            advance_();
+        }
+    }
+
+    // stops a task outside the head while the window is full. run(segment*, Task&) is handed the head's
+    // subtree when nobody has started it, and has to close the segment it is given.
+    template<typename Run>
+    void wait_for_room(segment* current, Run&& run) {
+        bool counted = false;
+        backoff idle;
+        while (!has_room() && !failed_.load(std::memory_order_relaxed)) {
+            std::shared_ptr<segment> unstarted;
+            std::optional<Task> task;
+            {
+                std::lock_guard lock(mutex_);
+                if (current == head_.get()) {
+                    return;
+                }
+                if (!counted) {
+                    stats_.window_waits++;
+                    counted = true;
+                }
+                if (!head_->claimed && head_->task) {
+                    head_->claimed = true;
+                    unstarted = head_;
+                    task = std::move(head_->task);
+                    stats_.helped++;
+                }
+            }
+
+            if (unstarted) {
+                run(unstarted.get(), *task);
+                idle.reset();
+                continue;
+            }
+            idle.pause();
+        }
+    }
+
+    // a task failed and its segment will never close: stop committing and release the waiting tasks
+    void abandon() { failed_.store(true, std::memory_order_relaxed); }
+
+    // records appended and not committed yet
+    [[nodiscard]] std::size_t waiting() const noexcept { return waiting_.load(std::memory_order_relaxed); }
+    // read once the search is done
+    [[nodiscard]] const reorder_stats& get_stats() const noexcept { return stats_; }
+};
+
+#endif //REORDER_BUFFER_H
@@ -0,0 +1,36 @@
+#ifndef SEARCH_CHECKPOINT_H
+#define SEARCH_CHECKPOINT_H
+#include <fullerene/fullerene_id.h>
+#include <generators/id_registry.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where a sequential main_generator search stood: every graph up to and including the last one on `path`
+// has been written, and the output held output_bytes bytes. path runs from C20 down to that graph; each
+// frame holds the graph's id and its position among the canonical children of the frame above.
+struct search_checkpoint {
+    struct frame {
+        std::size_t ordinal;
+        fullerene_id id;
+    };
+
+    std::size_t up_to = 0;
+    std::string format;
+    std::size_t split_res = 0;
+    std::size_t split_mod = 1;
+    int split_depth = 0;
+    std::size_t split_count = 0;
+    std::uint64_t output_bytes = 0;
+    id_registry::counter_map ids;
+    std::vector<frame> path;
+};
+
+// Writes a small text file next to `file` and renames it over `file`, so a crash never leaves a torn checkpoint.
+void write_checkpoint(const std::string& file, const search_checkpoint& checkpoint);
+
+// Throws std::runtime_error if the file can't be read or isn't a checkpoint.
+search_checkpoint read_checkpoint(const std::string& file);
+
+#endif //SEARCH_CHECKPOINT_H
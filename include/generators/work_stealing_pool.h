@@ -0,0 +1,130 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+#include <generators/backoff.h>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers with one task deque each. A worker takes its newest task first (depth first, good
+// locality) and, when its own deque is empty, steals the oldest task of another worker (the largest subtree).
+template<typename Task>
+class work_stealing_pool {
+public:
+    using handler = std::function<void(Task&, std::size_t worker)>;
+
+private:
+    struct worker_queue {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::atomic<std::size_t> pending_{ 0 };  // pushed and not yet finished
+    std::atomic<bool> failed_{ false };
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    bool pop_local_(const std::size_t worker, std::optional<Task>& task) {
+        auto& q = *queues_[worker];
+        std::lock_guard lock(q.mutex);
+        if (q.tasks.empty()) {
+            return false;
+        }
+        task.emplace(std::move(q.tasks.back()));
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal_(const std::size_t worker, std::optional<Task>& task) {
+        for (std::size_t k = 1; k < queues_.size(); k++) {
+            auto& q = *queues_[(worker + k) % queues_.size()];
+            std::lock_guard lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task.emplace(std::move(q.tasks.front()));
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work_(const std::size_t worker, const handler& h) {
+        std::optional<Task> task;
+        backoff idle;
+        while (true) {
+            if (pop_local_(worker, task) || steal_(worker, task)) {
+                idle.reset();
+                if (!failed_.load(std::memory_order_relaxed)) {
+                    try {
+                        h(*task, worker);
+                    } catch (...) {
+                        std::lock_guard lock(error_mutex_);
+                        if (!error_) {
+                            error_ = std::current_exception();
+                        }
+                        failed_ = true;
+                    }
+                }
+                task.reset();
+                pending_.fetch_sub(1, std::memory_order_acq_rel);
+                continue;
+            }
+
+            if (pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+            // nothing to steal for now, e.g. in the narrow top of the tree
+            idle.pause();
+        }
+    }
+
+public:
+    explicit work_stealing_pool(const std::size_t threads) {
+        for (std::size_t i = 0; i < (threads == 0 ? 1 : threads); i++) {
+            queues_.push_back(std::make_unique<worker_queue>());
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return queues_.size(); }
+
+    // tasks still waiting in the deque of the given worker
+    [[nodiscard]] std::size_t queued(const std::size_t worker) const {
+        auto& q = *queues_[worker];
+        std::lock_guard lock(q.mutex);
+        return q.tasks.size();
+    }
+
+    // called by a worker from inside the handler, or before run()
+    void push(const std::size_t worker, Task task) {
+        pending_.fetch_add(1, std::memory_order_acq_rel);
+        auto& q = *queues_[worker];
+        std::lock_guard lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+
+    // runs until every pushed task, including the ones pushed while running, has been handled;
+    // rethrows the first exception a handler threw
+    void run(const handler& h) {
+        std::vector<std::thread> threads;
+        threads.reserve(queues_.size());
+        for (std::size_t i = 0; i < queues_.size(); i++) {
+            threads.emplace_back([this, i, &h] { work_(i, h); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+};
+
+#endif //WORK_STEALING_POOL_H
@@ -1,6 +1,8 @@
 ﻿#include <queue>
 #include <expansions/b_expansion.h>
 #include <expansions/signature_state.h>
+#include <algorithm>
+#include <cstdint>
 
 void build_b_rails(const dual_fullerene& G,
                    const directed_edge& start,
@@ -15,26 +17,26 @@ void build_b_rails(const dual_fullerene& G,
     parallel_path.resize(total_length);
 
     auto e = start;
-    path[0] = static_cast<int>(e.from->id());
-    e = clockwise ? e.right_turn(3) : e.left_turn(3);
+    path[0] = static_cast<int>(e.from);
+    e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
 
     for (int k = 1; k < length_pre_bend + 2; ++k) {
-        path[k] = static_cast<int>(e.from->id());
-        auto side = clockwise ? e.next_around(2) : e.prev_around(2);
-        parallel_path[k - 1] = static_cast<int>(side.to()->id());
-        e = clockwise ? e.right_turn(3) : e.left_turn(3);
+        path[k] = static_cast<int>(e.from);
+        auto side = clockwise ? G.next_around(e, 2) : G.prev_around(e, 2);
+        parallel_path[k - 1] = static_cast<int>(G.to(side));
+        e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
     }
 
-    e = clockwise ? e.next_around() : e.prev_around();
+    e = clockwise ? G.next_around(e) : G.prev_around(e);
 
     for (int k = length_pre_bend + 2; k < total_length + 1; ++k) {
-        path[k] = static_cast<int>(e.from->id());
-        auto side = clockwise ? e.next_around() : e.prev_around();
-        parallel_path[k - 1] = static_cast<int>(side.to()->id());
-        e = clockwise ? e.right_turn(3) : e.left_turn(3);
+        path[k] = static_cast<int>(e.from);
+        auto side = clockwise ? G.next_around(e) : G.prev_around(e);
+        parallel_path[k - 1] = static_cast<int>(G.to(side));
+        e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
     }
 
-    path[total_length + 1] = static_cast<int>(e.from->id());
+    path[total_length + 1] = static_cast<int>(e.from);
 }
 
 std::vector<b_expansion_candidate> find_b_candidates(const dual_fullerene& G,
@@ -43,15 +45,15 @@ std::vector<b_expansion_candidate> find_b_candidates(const dual_fullerene& G,
 {
     std::vector<b_expansion_candidate> out;
 
-    for (const auto& node : G.get_nodes_5()) {
-        for (int i = 0; i < node->degree(); ++i) {
-            directed_edge e{ node, static_cast<std::size_t>(i) };
+    for (const auto node : G.get_nodes_5()) {
+        for (int i = 0; i < G.degree(node); ++i) {
+            directed_edge e{ node, static_cast<std::uint32_t>(i) };
 
             for (bool clockwise : { true, false }) {
                 std::vector<int> P, Q;
                 build_b_rails(G, e, clockwise, length_pre_bend, length_post_bend, P, Q);
 
-                if ((G.get_node(static_cast<unsigned>(P[P.size() - 1]))->degree() == 5) && patch_nodes_unique(P, Q))
+                if ((G.degree(static_cast<unsigned>(P[P.size() - 1])) == 5) && patch_nodes_unique(P, Q))
                     out.push_back({ e, clockwise, std::move(P), std::move(Q), length_pre_bend, length_post_bend });
             }
         }
@@ -60,8 +62,100 @@ std::vector<b_expansion_candidate> find_b_candidates(const dual_fullerene& G,
     return out;
 }
 
+namespace {
+
+    // Walks the straight rail from one pentagon edge once and, from every bend point on it, the rail after the
+    // bend, calling emit(pre, post, path, parallel_path) for every candidate with pre + post <= max_sum. All
+    // splits share the straight prefix, and the bent rails of one pre the prefix of the shorter posts. A walk stops
+    // at the first vertex it meets twice: no candidate through it has unique patch nodes. `seen` is all zero
+    // before and after.
+    template<typename Emit>
+    void walk_b_rails(const dual_fullerene& G, const directed_edge& start, const bool clockwise, const int max_sum,
+        std::vector<std::uint8_t>& seen, std::vector<int>& path, std::vector<int>& parallel_path, Emit&& emit)
+    {
+        const auto turn = [&](const directed_edge e) { return clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3); };
+        // marks v and appends it to the rail, false if it was met before
+        const auto take = [&](const unsigned int v, std::vector<int>& rail) {
+            if (seen[v]) {
+                return false;
+            }
+            seen[v] = 1;
+            rail.push_back(static_cast<int>(v));
+            return true;
+        };
+        const auto unwind = [&](const std::size_t path_size, const std::size_t parallel_size) {
+            for (; path.size() > path_size; path.pop_back()) seen[path.back()] = 0;
+            for (; parallel_path.size() > parallel_size; parallel_path.pop_back()) seen[parallel_path.back()] = 0;
+        };
+
+        path.clear();
+        parallel_path.clear();
+        auto e = start;
+        take(e.from, path);
+        e = turn(e);
+
+        for (int pre = 0; pre <= max_sum; ++pre) {
+            const auto side = clockwise ? G.next_around(e, 2) : G.prev_around(e, 2);
+            if (!take(e.from, path) || !take(G.to(side), parallel_path)) {
+                break;
+            }
+            e = turn(e);
+
+            const auto straight_path = path.size();
+            const auto straight_parallel = parallel_path.size();
+            auto bent = clockwise ? G.next_around(e) : G.prev_around(e);
+            // after step j the rail closes a candidate with post = j - 1 at the next vertex
+            for (int j = 0; j <= max_sum - pre + 1; ++j) {
+                const auto bent_side = clockwise ? G.next_around(bent) : G.prev_around(bent);
+                if (!take(bent.from, path) || !take(G.to(bent_side), parallel_path)) {
+                    break;
+                }
+                bent = turn(bent);
+
+                if (j > 0 && !seen[bent.from] && G.degree(bent.from) == 5) {
+                    path.push_back(static_cast<int>(bent.from));
+                    emit(pre, j - 1, path, parallel_path);
+                    path.pop_back();
+                }
+            }
+            unwind(straight_path, straight_parallel);
+        }
+        unwind(0, 0);
+    }
+
+}
+
+std::vector<std::vector<std::vector<b_expansion_candidate>>> find_b_candidates_up_to(const dual_fullerene& G,
+    int max_param_sum)
+{
+    std::vector<std::vector<std::vector<b_expansion_candidate>>> out(std::max(max_param_sum + 1, 0));
+    for (int pre = 0; pre <= max_param_sum; ++pre) {
+        out[pre].resize(max_param_sum - pre + 1);
+    }
+
+    std::vector<std::uint8_t> seen(G.total_nodes(), 0);
+    std::vector<int> P, Q;
+    P.reserve(max_param_sum + 5);
+    Q.reserve(max_param_sum + 3);
+
+    for (const auto node : G.get_nodes_5()) {
+        for (std::uint32_t i = 0; i < G.degree(node); ++i) {
+            directed_edge e{ node, i };
+
+            for (bool clockwise : { true, false }) {
+                walk_b_rails(G, e, clockwise, max_param_sum, seen, P, Q,
+                    [&](const int pre, const int post, const std::vector<int>& path, const std::vector<int>& parallel_path) {
+                        out[pre][post].push_back({ { e, clockwise, path, parallel_path }, pre, post });
+                    });
+            }
+        }
+    }
+
+    return out;
+}
+
 bool b_expansion::validate() const {
-    return G_.get_node(static_cast<unsigned>(cand_.path[cand_.path.size() - 1]))->degree() == 5;
+    return G_.degree(static_cast<unsigned>(cand_.path[cand_.path.size() - 1])) == 5;
 }
 
 void b_expansion::apply() {
@@ -76,28 +170,22 @@ void b_expansion::apply() {
 
     // first external hexagon
     const int h1 = G_.add_vertex(node_type::NODE_6);
-    auto h1_node = G_.get_node(h1);
 
     G_.move_neighborhood(u0, h1);
 
-    auto u0_node = G_.get_node(u0);;
-    auto u1_node = G_.get_node(u1);
-    auto w0_node = G_.get_node(w0);
-    auto w1_node = G_.get_node(w1);
-
     if (c.clockwise) {
         G_.add_neighbor_after(h1, u1, u0);
-        u0_node->add_neighbor(u1_node);
-        u0_node->add_neighbor(w1_node);
-        u0_node->add_neighbor(w0_node);
-        u0_node->add_neighbor(h1_node);
+        G_.add_neighbor(u0, u1);
+        G_.add_neighbor(u0, w1);
+        G_.add_neighbor(u0, w0);
+        G_.add_neighbor(u0, h1);
     }
     else {
         G_.add_neighbor_before(h1, u1, u0);
-        u0_node->add_neighbor(h1_node);
-        u0_node->add_neighbor(w0_node);
-        u0_node->add_neighbor(w1_node);
-        u0_node->add_neighbor(u1_node);
+        G_.add_neighbor(u0, h1);
+        G_.add_neighbor(u0, w0);
+        G_.add_neighbor(u0, w1);
+        G_.add_neighbor(u0, u1);
     }
 
     G_.replace_neighbor(u1, w0, u0);
@@ -114,29 +202,22 @@ void b_expansion::apply() {
             int u_second = c.path[j + 1];
             int w_first = c.parallel_path[j];
             int w_second = c.parallel_path[j + 1];
-            auto u_first_node = G_.get_node(u_first);
-            auto u_second_node = G_.get_node(u_second);
-            auto w_first_node = G_.get_node(w_first);
-            auto w_second_node = G_.get_node(w_second);
-            auto corridor_node = G_.get_node(corridor_v);
-            auto h_node = G_.get_node(h);
-            h_node->clear_neighbors();
 
             if (c.clockwise) {
                 G_.add_neighbor_after(corridor_v, u_first, h);
-                h_node->add_neighbor(w_first_node);
-                h_node->add_neighbor(corridor_node);
-                h_node->add_neighbor(u_first_node);
-                h_node->add_neighbor(u_second_node);
-                h_node->add_neighbor(w_second_node);
+                G_.add_neighbor(h, w_first);
+                G_.add_neighbor(h, corridor_v);
+                G_.add_neighbor(h, u_first);
+                G_.add_neighbor(h, u_second);
+                G_.add_neighbor(h, w_second);
             }
             else {
                 G_.add_neighbor_before(corridor_v, u_first, h);
-                h_node->add_neighbor(w_second_node);
-                h_node->add_neighbor(u_second_node);
-                h_node->add_neighbor(u_first_node);
-                h_node->add_neighbor(corridor_node);
-                h_node->add_neighbor(w_first_node);
+                G_.add_neighbor(h, w_second);
+                G_.add_neighbor(h, u_second);
+                G_.add_neighbor(h, u_first);
+                G_.add_neighbor(h, corridor_v);
+                G_.add_neighbor(h, w_first);
             }
 
             G_.replace_neighbor(u_first, w_first, h);
@@ -154,29 +235,22 @@ void b_expansion::apply() {
         int u_second = c.path[i1 + 2];
         int u_third = c.path[i1 + 3];
         int w_first = c.parallel_path[i1 + 1];
-        auto u_first_node = G_.get_node(u_first);
-        auto u_second_node = G_.get_node(u_second);
-        auto u_third_node = G_.get_node(u_third);
-        auto w_first_node = G_.get_node(w_first);
-        auto corridor_node = G_.get_node(corridor_v);
-        auto h_node = G_.get_node(h);
-        h_node->clear_neighbors();
 
         if (c.clockwise) {
             G_.add_neighbor_after(corridor_v, u_first, h);
-            h_node->add_neighbor(w_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(u_third_node);
+            G_.add_neighbor(h, w_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, u_third);
         }
         else {
             G_.add_neighbor_before(corridor_v, u_first, h);
-            h_node->add_neighbor(u_third_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(w_first_node);
+            G_.add_neighbor(h, u_third);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, w_first);
         }
 
         G_.replace_neighbor(u_first, w_first, h);
@@ -193,29 +267,22 @@ void b_expansion::apply() {
         int u_second = c.path[j + 3];
         int w_first = c.parallel_path[j];
         int w_second = c.parallel_path[j + 1];
-        auto u_first_node = G_.get_node(u_first);
-        auto u_second_node = G_.get_node(u_second);
-        auto w_first_node = G_.get_node(w_first);
-        auto w_second_node = G_.get_node(w_second);
-        auto corridor_node = G_.get_node(corridor_v);
-        auto h_node = G_.get_node(h);
-        h_node->clear_neighbors();
 
         if (c.clockwise) {
             G_.add_neighbor_after(corridor_v, u_first, h);
-            h_node->add_neighbor(w_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(w_second_node);
+            G_.add_neighbor(h, w_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, w_second);
         }
         else {
             G_.add_neighbor_before(corridor_v, u_first, h);
-            h_node->add_neighbor(w_second_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(w_first_node);
+            G_.add_neighbor(h, w_second);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, w_first);
         }
 
         G_.replace_neighbor(w_first, u_first, h);
@@ -228,184 +295,198 @@ void b_expansion::apply() {
     // second external hexagon
     {
         const int h2 = G_.add_vertex(node_type::NODE_6);
-        auto h2_node = G_.get_node(h2);
         int u_first = c.path[i_total + 3];
         int u_second = c.path[i_total + 4];
         int w_first = c.parallel_path[i_total + 1];
         int w_second = c.parallel_path[i_total + 2];
-        auto u_first_node = G_.get_node(u_first);
-        auto u_second_node = G_.get_node(u_second);
-        auto w_first_node = G_.get_node(w_first);
-        auto w_second_node = G_.get_node(w_second);
-        auto corridor_node = G_.get_node(corridor_v);
 
         G_.move_neighborhood(u_second, h2);
 
         if (c.clockwise) {
             G_.add_neighbor_after(corridor_v, u_first, u_second);
             G_.add_neighbor_after(h2, w_second, u_second);
-            u_second_node->add_neighbor(w_first_node);
-            u_second_node->add_neighbor(corridor_node);
-            u_second_node->add_neighbor(u_first_node);
-            u_second_node->add_neighbor(h2_node);
-            u_second_node->add_neighbor(w_second_node);
+            G_.add_neighbor(u_second, w_first);
+            G_.add_neighbor(u_second, corridor_v);
+            G_.add_neighbor(u_second, u_first);
+            G_.add_neighbor(u_second, h2);
+            G_.add_neighbor(u_second, w_second);
         }
         else {
             G_.add_neighbor_before(corridor_v, u_first, u_second);
             G_.add_neighbor_before(h2, w_second, u_second);
-            u_second_node->add_neighbor(h2_node);
-            u_second_node->add_neighbor(u_first_node);
-            u_second_node->add_neighbor(corridor_node);
-            u_second_node->add_neighbor(w_first_node);
-            u_second_node->add_neighbor(w_second_node);
+            G_.add_neighbor(u_second, h2);
+            G_.add_neighbor(u_second, u_first);
+            G_.add_neighbor(u_second, corridor_v);
+            G_.add_neighbor(u_second, w_first);
+            G_.add_neighbor(u_second, w_second);
         }
 
         G_.replace_neighbor(u_first, w_second, u_second);
         G_.replace_neighbor(w_first, u_first, u_second);
         G_.replace_neighbor(w_second, u_first, u_second);
 
-        inv_first_ = c.clockwise ? u0_node->get_edge(u1_node).next_around() : u0_node->get_edge(u1_node).prev_around();
-        inv_second_ = u_second_node->get_edge(corridor_node);
+        inv_first_ = c.clockwise ? G_.next_around(G_.get_edge_to(u0, u1)) : G_.prev_around(G_.get_edge_to(u0, u1));
+        inv_second_ = G_.get_edge_to(u_second, corridor_v);
     }
 }
 
-std::vector<std::unique_ptr<base_expansion>> find_b_expansions(dual_fullerene& G,
-    int length_pre_bend,
-    int length_post_bend)
-{
-    std::vector<std::unique_ptr<base_expansion>> out;
+namespace {
 
-    const auto candidates = find_b_candidates(G, length_pre_bend, length_post_bend);
-    std::size_t n = candidates.size();
-    if (n == 0) {
-        return out;
-    }
+    // appends an expansion for one candidate of each group that the signatures can't tell apart
+    void append_b_representatives(dual_fullerene& G, const std::vector<b_expansion_candidate>& candidates,
+        std::vector<std::unique_ptr<base_expansion>>& out)
+    {
+        std::size_t n = candidates.size();
+        if (n == 0) {
+            return;
+        }
 
-    std::vector<signature_state> states;
-    states.reserve(n);
-    for (const auto& c : candidates) {
-        states.emplace_back(G, c);
-    }
+        std::vector<signature_state> states;
+        states.reserve(n);
+        for (const auto& c : candidates) {
+            states.emplace_back(G, c);
+        }
 
-    struct Group {
-        std::vector<std::size_t> members;
-        std::size_t prefix_len;
-    };
+        struct Group {
+            std::vector<std::size_t> members;
+            std::size_t prefix_len;
+        };
 
-    std::queue<Group> groups;
-    Group initial;
-    initial.members.reserve(n);
-    for (std::size_t i = 0; i < n; ++i) {
-        initial.members.push_back(i);
-    }
-    initial.prefix_len = 0;
-    groups.push(initial);
+        std::queue<Group> groups;
+        Group initial;
+        initial.members.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            initial.members.push_back(i);
+        }
+        initial.prefix_len = 0;
+        groups.push(initial);
 
-    std::vector<bool> is_representative(n, false);
+        std::vector<bool> is_representative(n, false);
 
-    while (!groups.empty()) {
-        Group g = groups.front();
-        groups.pop();
+        while (!groups.empty()) {
+            Group g = groups.front();
+            groups.pop();
 
-        if (g.members.empty()) {
-            continue;
-        }
+            if (g.members.empty()) {
+                continue;
+            }
 
-        if (g.members.size() == 1) {
-            std::size_t idx = g.members.front();
-            if (!is_representative[idx]) {
-                is_representative[idx] = true;
+            if (g.members.size() == 1) {
+                std::size_t idx = g.members.front();
+                if (!is_representative[idx]) {
+                    is_representative[idx] = true;
+                }
+                continue;
             }
-            continue;
-        }
 
-        for (std::size_t idx : g.members) {
-            states[idx].extend_step();
-        }
+            for (std::size_t idx : g.members) {
+                states[idx].extend_step();
+            }
 
-        std::vector<std::vector<std::size_t>> subgroups;
-        std::vector<std::size_t> reps;
+            std::vector<std::vector<std::size_t>> subgroups;
+            std::vector<std::size_t> reps;
 
-        for (std::size_t idx : g.members) {
-            const auto& sig = states[idx].signature();
+            for (std::size_t idx : g.members) {
+                const auto& sig = states[idx].signature();
 
-            bool placed = false;
-            for (std::size_t k = 0; k < reps.size(); ++k) {
-                std::size_t rep_idx = reps[k];
-                const auto& rep_sig = states[rep_idx].signature();
+                bool placed = false;
+                for (std::size_t k = 0; k < reps.size(); ++k) {
+                    std::size_t rep_idx = reps[k];
+                    const auto& rep_sig = states[rep_idx].signature();
 
-                if (sig.size() != rep_sig.size()) {
-                    continue;
-                }
+                    if (sig.size() != rep_sig.size()) {
+                        continue;
+                    }
 
-                bool equal = true;
-                std::size_t start = g.prefix_len;
-                std::size_t end = sig.size();
-                for (std::size_t p = start; p < end; ++p) {
-                    if (sig[p] != rep_sig[p]) {
-                        equal = false;
+                    bool equal = true;
+                    std::size_t start = g.prefix_len;
+                    std::size_t end = sig.size();
+                    for (std::size_t p = start; p < end; ++p) {
+                        if (sig[p] != rep_sig[p]) {
+                            equal = false;
+                            break;
+                        }
+                    }
+
+                    if (equal) {
+                        subgroups[k].push_back(idx);
+                        placed = true;
                         break;
                     }
                 }
 
-                if (equal) {
-                    subgroups[k].push_back(idx);
-                    placed = true;
-                    break;
+                if (!placed) {
+                    reps.push_back(idx);
+                    subgroups.push_back(std::vector<std::size_t>{idx});
                 }
             }
 
-            if (!placed) {
-                reps.push_back(idx);
-                subgroups.push_back(std::vector<std::size_t>{idx});
-            }
-        }
+            for (std::size_t k = 0; k < subgroups.size(); ++k) {
+                auto& members = subgroups[k];
+                if (members.empty()) {
+                    continue;
+                }
 
-        for (std::size_t k = 0; k < subgroups.size(); ++k) {
-            auto& members = subgroups[k];
-            if (members.empty()) {
-                continue;
-            }
+                if (members.size() == 1) {
+                    std::size_t idx = members.front();
+                    if (!is_representative[idx]) {
+                        is_representative[idx] = true;
+                    }
+                    continue;
+                }
 
-            if (members.size() == 1) {
-                std::size_t idx = members.front();
-                if (!is_representative[idx]) {
-                    is_representative[idx] = true;
+                bool all_finished = true;
+                for (std::size_t idx : members) {
+                    if (!states[idx].finished()) {
+                        all_finished = false;
+                        break;
+                    }
                 }
-                continue;
-            }
 
-            bool all_finished = true;
-            for (std::size_t idx : members) {
-                if (!states[idx].finished()) {
-                    all_finished = false;
-                    break;
+                if (all_finished) {
+                    std::size_t idx = members.front();
+                    if (!is_representative[idx]) {
+                        is_representative[idx] = true;
+                    }
+                }
+                else {
+                    Group ng;
+                    ng.members = std::move(members);
+                    ng.prefix_len = states[reps[k]].signature().size();
+                    groups.push(std::move(ng));
                 }
             }
+        }
 
-            if (all_finished) {
-                std::size_t idx = members.front();
-                if (!is_representative[idx]) {
-                    is_representative[idx] = true;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (is_representative[i]) {
+                auto e = std::make_unique<b_expansion>(G, candidates[i]);
+                if (e->validate()) {
+                    out.push_back(std::move(e));
                 }
             }
-            else {
-                Group ng;
-                ng.members = std::move(members);
-                ng.prefix_len = states[reps[k]].signature().size();
-                groups.push(std::move(ng));
-            }
         }
     }
 
-    for (std::size_t i = 0; i < n; ++i) {
-        if (is_representative[i]) {
-            auto e = std::make_unique<b_expansion>(G, candidates[i]);
-            if (e->validate()) {
-                out.push_back(std::move(e));
-            }
+}
+
+std::vector<std::unique_ptr<base_expansion>> find_b_expansions(dual_fullerene& G,
+    int length_pre_bend,
+    int length_post_bend)
+{
+    std::vector<std::unique_ptr<base_expansion>> out;
+    append_b_representatives(G, find_b_candidates(G, length_pre_bend, length_post_bend), out);
+    return out;
+}
+
+std::vector<std::unique_ptr<base_expansion>> find_b_expansions_up_to(dual_fullerene& G, int max_param_sum)
+{
+    std::vector<std::unique_ptr<base_expansion>> out;
+    const auto by_split = find_b_candidates_up_to(G, max_param_sum);
+    for (int sum = 0; sum <= max_param_sum; ++sum) {
+        for (int pre = 0; pre <= sum; ++pre) {
+            append_b_representatives(G, by_split[pre][sum - pre], out);
         }
     }
-
     return out;
 }
@@ -9,20 +9,20 @@ find_b_reductions(const dual_fullerene& G, int length_pre_bend, int length_post_
 {
 	std::vector<b_reduction> out;
 	const int total_length = length_pre_bend + length_post_bend + 3;
-	for (const auto& node : G.get_nodes_5()) {
-		for (int i = 0; i < node->degree(); ++i) {
-			directed_edge e0{ node, static_cast<std::size_t>(i) };
-			   if (e0.to()->type() != node_type::NODE_6) {
+	for (const auto node : G.get_nodes_5()) {
+		for (int i = 0; i < G.degree(node); ++i) {
+			directed_edge e0{ node, static_cast<std::uint32_t>(i) };
+			   if (G.type(G.to(e0)) != node_type::NODE_6) {
 			       continue;
 			   }
 			
 			for (bool clockwise : { true, false }) {
-				if (node->id() == skip_pent && i == skip_index && clockwise == skip_clockwise) {
+				if (node == skip_pent && i == skip_index && clockwise == skip_clockwise) {
 					continue;
 				}
 				int outside_hex1 = clockwise
-					? static_cast<int>(e0.prev_around(2).to()->degree())
-					: static_cast<int>(e0.next_around(2).to()->degree());
+					? static_cast<int>(G.degree(G.to(G.prev_around(e0, 2))))
+					: static_cast<int>(G.degree(G.to(G.next_around(e0, 2))));
 				if (outside_hex1 != 6) continue;
 				auto e = e0;
 				std::vector<int> path;
@@ -32,46 +32,45 @@ find_b_reductions(const dual_fullerene& G, int length_pre_bend, int length_post_
 					auto v = e.from;
 
 					if (step == 0) {
-						if (v->type() != node_type::NODE_5) {
+						if (G.type(v) != node_type::NODE_5) {
 							ok = false;
 							break;
 						}
 					}
 					else {
-						if (v->type() != node_type::NODE_6) {
+						if (G.type(v) != node_type::NODE_6) {
 							ok = false;
 							break;
 						}
 					}
-					path.push_back(static_cast<int>(v->id()));
+					path.push_back(static_cast<int>(v));
 
 					if (step < length_pre_bend) {
-						e = clockwise ? e.right_turn(3) : e.left_turn(3);
+						e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
 					}
 				}
 				if (!ok) continue;
-				e = clockwise ? e.right_turn(2) : e.left_turn(2);
+				e = clockwise ? G.right_turn(e, 2) : G.left_turn(e, 2);
 
 
 				for (int step = 0; step <= length_post_bend; ++step) {
 					auto v = e.from;
 
-					if (v->type() != node_type::NODE_6) {
+					if (G.type(v) != node_type::NODE_6) {
 						ok = false;
 						break;
 					}
 
-					path.push_back(static_cast<int>(v->id()));
-					e = clockwise ? e.right_turn(3) : e.left_turn(3);
+					path.push_back(static_cast<int>(v));
+					e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
 				}
 
 				if (!ok) continue;
 				auto second_pent = e.from;
-				if (second_pent->type() != node_type::NODE_5) {
+				if (G.type(second_pent) != node_type::NODE_5) {
 					continue;
 				}
-				auto prev_node = G.get_node(path.back());
-				directed_edge second_edge = second_pent->get_edge(prev_node);
+				directed_edge second_edge = G.get_edge_to(second_pent, static_cast<unsigned int>(path.back()));
 				b_reduction r;
 				r.first_edge = e0;
 				r.second_edge = second_edge;
@@ -118,12 +117,10 @@ void b_reduction::apply(dual_fullerene& G, const expansion_candidate& c_base) co
 		const int u_second = c.path[i_total + 4];
 		const int w_first = c.parallel_path[i_total + 1];
 		const int w_second = c.parallel_path[i_total + 2];
-		auto h2_node = G.get_node(static_cast<unsigned>(h2));
-		auto u_second_node = G.get_node(static_cast<unsigned>(u_second));
 		G.replace_neighbor(w_second, u_second, u_first);
 		G.replace_neighbor(w_first, u_second, u_first);
 		G.replace_neighbor(u_first, u_second, w_second);
-		h2_node->remove_neighbor(u_second_node);
+		G.remove_neighbor(h2, u_second);
 		G.move_neighborhood(h2, u_second);
 		G.pop_last_node6();
 		--h;
@@ -185,13 +182,11 @@ void b_reduction::apply(dual_fullerene& G, const expansion_candidate& c_base) co
 		const int w0 = c.parallel_path[0];
 		const int w1 = c.parallel_path[1];
 
-		auto h1_node = G.get_node(static_cast<unsigned>(h1));
-		auto u0_node = G.get_node(static_cast<unsigned>(u0));
 		G.replace_neighbor(w1, u0, u1);
 		G.replace_neighbor(w0, u0, u1);
 		G.replace_neighbor(u1, u0, w0);
 
-		h1_node->remove_neighbor(u0_node);
+		G.remove_neighbor(h1, u0);
 		G.move_neighborhood(h1, u0);
 		G.pop_last_node6();
 
@@ -2,9 +2,9 @@
 #include <expansions/signature_state.h>
 #include <expansions/l_reduction.h>
 #include <expansions/b_reduction.h>
+#include <expansions/reduction_catalogue.h>
 
 #include <cstdint>
-#include <memory>
 #include <vector>
 #include <iostream>
 #include <typeinfo>
@@ -12,7 +12,7 @@
 
 
 
-static std::uint32_t edge_neighborhood_code(const directed_edge& e, bool use_next)
+static std::uint32_t edge_neighborhood_code(const dual_fullerene& G, const directed_edge& e, bool use_next)
 {
     auto e0 = e;
     std::uint32_t code = 0;
@@ -23,13 +23,13 @@ static std::uint32_t edge_neighborhood_code(const directed_edge& e, bool use_nex
         };
 
     for (int k = 0; k < 5; k++) {
-        pack(static_cast<int>(e0.to()->degree()));
-        e0 = use_next ? e0.next_around() : e0.prev_around();
+        pack(static_cast<int>(G.degree(G.to(e0))));
+        e0 = use_next ? G.next_around(e0) : G.prev_around(e0);
     }
     return code;
 }
 
-static std::uint32_t path_neighborhood_code(const base_reduction& r, int edges_len = 7)
+static std::uint32_t path_neighborhood_code(const dual_fullerene& G, const base_reduction& r, int edges_len = 7)
 {
     std::uint32_t code = 0;
     if (edges_len <= 0) return code;
@@ -37,13 +37,13 @@ static std::uint32_t path_neighborhood_code(const base_reduction& r, int edges_l
     auto e = r.first_edge;
 
     for (int step = 0; step < edges_len; ++step) {
-        e = r.use_next ? e.right_turn(3) : e.left_turn(3);
+        e = r.use_next ? G.right_turn(e, 3) : G.left_turn(e, 3);
 
-        auto ep = e.prev_around();
-        auto en = e.next_around();
+        auto ep = G.prev_around(e);
+        auto en = G.next_around(e);
 
-        int dp = static_cast<int>(ep.to()->degree());
-        int dn = static_cast<int>(en.to()->degree());
+        int dp = static_cast<int>(G.degree(G.to(ep)));
+        int dn = static_cast<int>(G.degree(G.to(en)));
 
         std::uint32_t bits = 0;
         if (r.use_next) {
@@ -62,19 +62,19 @@ static std::uint32_t path_neighborhood_code(const base_reduction& r, int edges_l
     return code;
 }
 
-std::uint32_t base_reduction::x2_code() const
+std::uint32_t base_reduction::x2_code(const dual_fullerene& G) const
 {
-    return edge_neighborhood_code(first_edge, use_next);
+    return edge_neighborhood_code(G, first_edge, use_next);
 }
 
-std::uint32_t base_reduction::x3_code() const
+std::uint32_t base_reduction::x3_code(const dual_fullerene& G) const
 {
-    return edge_neighborhood_code(second_edge, use_next);
+    return edge_neighborhood_code(G, second_edge, use_next);
 }
 
-std::uint32_t base_reduction::x4_code() const
+std::uint32_t base_reduction::x4_code(const dual_fullerene& G) const
 {
-    return path_neighborhood_code(*this, 7);
+    return path_neighborhood_code(G, *this, 7);
 }
 
 void base_reduction::fill_signature_candidate(expansion_candidate& out) const
@@ -85,8 +85,15 @@ void base_reduction::fill_signature_candidate(expansion_candidate& out) const
     out.parallel_path.clear();
 }
 
-bool base_reduction::is_canonical(const dual_fullerene& G, int min_x0, int l1, int l2) const
+bool base_reduction::is_canonical(const dual_fullerene& G, int min_x0, int l1) const
 {
+    reduction_catalogue reductions(G);
+    return is_canonical(reductions, min_x0, l1);
+}
+
+bool base_reduction::is_canonical(reduction_catalogue& reductions, int min_x0, int l1) const
+{
+    const auto& G = reductions.graph();
     const int ref_x0 = x0();
 
     if (ref_x0 > 2 && !G.is_ipr()) {
@@ -94,74 +101,49 @@ bool base_reduction::is_canonical(const dual_fullerene& G, int min_x0, int l1, i
     }
 
     for (int s = min_x0; s < ref_x0; ++s) {
-        auto smaller = find_all_reductions(G, s, -1, -1, true, -1, -1);
-        if (!smaller.empty()) {
+        if (reductions.has_reductions(s)) {
             return false;
         }
     }
-    
 
-    auto candidates = find_all_reductions(G, ref_x0, first_edge.from->id(), first_edge.index, use_next, l1, l2);
+    std::vector<const base_reduction*> candidates;
+    reductions.collect(ref_x0, static_cast<int>(first_edge.from), static_cast<int>(first_edge.index), use_next, l1, candidates);
     if (candidates.empty()) return true;
-    
-    const int ref_x1 = x1();
-    {
-        std::vector<std::unique_ptr<base_reduction>> next;
-        next.reserve(candidates.size());
-        for (auto& r : candidates) {
-            int v = r->x1();
-            if (v < ref_x1) {
+
+    // keeps the candidates whose code equals the reference's; false once one is smaller
+    const auto narrow = [&](const std::int64_t ref, auto&& code) {
+        std::size_t kept = 0;
+        for (const auto* r : candidates) {
+            const std::int64_t v = code(*r);
+            if (v < ref) {
                 return false;
             }
-            if (v == ref_x1) next.push_back(std::move(r));
+            if (v == ref) candidates[kept++] = r;
         }
-        candidates.swap(next);
-    }
+        candidates.resize(kept);
+        return true;
+    };
 
+    if (!narrow(x1(), [](const base_reduction& r) { return r.x1(); })) {
+        return false;
+    }
     if (candidates.empty()) return true;
-    
-    const std::uint32_t ref_x2 = x2_code();
-    {
-        std::vector<std::unique_ptr<base_reduction>> next;
-        next.reserve(candidates.size());
-        for (auto& r : candidates) {
-            std::uint32_t v = r->x2_code();
-            if (v < ref_x2) {
-                return false;
-            }
-            if (v == ref_x2) next.push_back(std::move(r));
-        }
-        candidates.swap(next);
+
+    if (!narrow(x2_code(G), [&](const base_reduction& r) { return r.x2_code(G); })) {
+        return false;
     }
     if (candidates.empty()) return true;
-    
-
-    const std::uint32_t ref_x3 = x3_code();
-    {
-        std::vector<std::unique_ptr<base_reduction>> next;
-        next.reserve(candidates.size());
-        for (auto& r : candidates) {
-            std::uint32_t v = r->x3_code();
-            if (v < ref_x3) return false;
-            if (v == ref_x3) next.push_back(std::move(r));
-        }
-        candidates.swap(next);
+
+    if (!narrow(x3_code(G), [&](const base_reduction& r) { return r.x3_code(G); })) {
+        return false;
     }
     if (candidates.empty()) return true;
 
-    const std::uint32_t ref_x4 = x4_code();
-    {
-        std::vector<std::unique_ptr<base_reduction>> next;
-        next.reserve(candidates.size());
-        for (auto& r : candidates) {
-            std::uint32_t v = r->x4_code();
-            if (v < ref_x4) return false;
-            if (v == ref_x4) next.push_back(std::move(r));
-        }
-        candidates.swap(next);
+    if (!narrow(x4_code(G), [&](const base_reduction& r) { return r.x4_code(G); })) {
+        return false;
     }
     if (candidates.empty()) return true;
-    
+
     expansion_candidate ref_cand;
     fill_signature_candidate(ref_cand);
     signature_state ref_state(G, ref_cand);
@@ -223,47 +205,12 @@ bool base_reduction::is_canonical(const dual_fullerene& G, int min_x0, int l1, i
     return true;
 }
 
-std::vector<std::unique_ptr<base_reduction>>
-find_all_reductions(const dual_fullerene& G, int x0, int skip_pent, int skip_index, bool skip_clockwise, int skip_l1, int skip_l2)
-{
-    std::vector<std::unique_ptr<base_reduction>> out;
-
-    const int l_param = x0;
-    if (l_param >= 1) {
-        std::vector<l_reduction> ls;
-        if (skip_l1 >= 0) {
-            ls = find_l_reductions(G, l_param, -1, -1, skip_clockwise);
-        }
-        else {
-            ls = find_l_reductions(G, l_param, skip_pent, skip_index, skip_clockwise);
-        }
-        
-        out.reserve(ls.size());
-        for (auto& r : ls) {
-            out.push_back(std::make_unique<l_reduction>(std::move(r)));
-        }
-    }
-    const int b_sum = x0 - 2;
-    for (int b = 0; b <= b_sum; b++) {
-        std::vector<b_reduction> bs;
-        if (b == skip_l1) {
-            bs = find_b_reductions(G, b, b_sum - b, skip_pent, skip_index, skip_clockwise);
-        }
-        else {
-            bs = find_b_reductions(G, b, b_sum - b, -1, -1, true);
-        }
-        
-        out.reserve(out.size() + bs.size());
-        for (auto& r : bs) {
-            out.push_back(std::make_unique<b_reduction>(std::move(r)));
-        }
-    }
-
-    return out;
+int limit_by_reduction_distances(const dual_fullerene& G, int cur_best) {
+    reduction_catalogue reductions(G);
+    return limit_by_reduction_distances(reductions, cur_best);
 }
 
-
-int limit_by_reduction_distances(const dual_fullerene& G, int cur_best) {
+int limit_by_reduction_distances(reduction_catalogue& reductions, int cur_best) {
     constexpr int N = 12;
     constexpr uint16_t FULL = (1u << N) - 1u; 
     std::array<uint8_t, 1u << N> seenPents{};
@@ -274,10 +221,11 @@ int limit_by_reduction_distances(const dual_fullerene& G, int cur_best) {
 
     int distinctEdges = 0;
 
-    auto reds = find_all_reductions(G, 2, -1, -1, true, -1, -1);
+    std::vector<const base_reduction*> reds;
+    reductions.collect(2, -1, -1, true, -1, reds);
 
-    for (const auto& r : reds) {
-        int a = r->first_edge.from->id(), b = r->second_edge.from->id();
+    for (const auto* r : reds) {
+        int a = r->first_edge.from, b = r->second_edge.from;
         uint16_t e = (uint16_t)((1u << a) | (1u << b));
 
         if (seenPents[e]) continue;
@@ -1,8 +1,8 @@
 ﻿#include"expansions/f_expansion.h"
 
 bool f_expansion::validate() const {
-    for (const auto& u : v_->neighbors()) {
-        if (u.lock()->type() == node_type::NODE_6) {
+    for (std::size_t i = 0; i < G_.degree(v_); i++) {
+        if (G_.type(G_.neighbor_at(v_, i)) == node_type::NODE_6) {
             return false;
         }
     }
@@ -11,46 +11,45 @@ bool f_expansion::validate() const {
 }
 
 void f_expansion::apply(){
-    std::array<std::shared_ptr<node_6>, 5> new_nodes{};
+    std::array<int, 5> new_nodes{};
 
     for (auto & new_node : new_nodes) {
-        new_node = node_6::create_sized(G_.total_nodes());
-        G_.add_node(new_node);
+        new_node = G_.add_sized_vertex(node_type::NODE_6);
     }
 
     for (int i = 0; i < 5; i++) {
-        auto& v1 = new_nodes[i];
-        auto& v2 = new_nodes[(i + 1) % 5];
+        const auto v1 = new_nodes[i];
+        const auto v2 = new_nodes[(i + 1) % 5];
 
-        v1->set_neighbor_at(3, v2);
-        v2->set_neighbor_at(0, v1);
+        G_.set_neighbor_at(v1, 3, v2);
+        G_.set_neighbor_at(v2, 0, v1);
     }
 
     std::array<directed_edge, 5> edges;
 
     for (int i = 0; i < 5; i++) {
-        edges[i] = v_->get_edge(i);
+        edges[i] = G_.get_edge(v_, i);
     }
 
     for (int i = 0; i < 5; i++) {
-        auto edge_l = edges[i].left_turn(2);
-        auto edge_r = edges[i].right_turn(2);
-        auto edge_l_inv = edge_l.inverse();
-        auto edge_r_inv = edge_r.inverse();
+        auto edge_l = G_.left_turn(edges[i], 2);
+        auto edge_r = G_.right_turn(edges[i], 2);
+        auto edge_l_inv = G_.inverse(edge_l);
+        auto edge_r_inv = G_.inverse(edge_r);
 
-        const auto& curr_new_node = new_nodes[i];
-        const auto& next_new_node = new_nodes[(i + 1) % 5];
+        const auto curr_new_node = new_nodes[i];
+        const auto next_new_node = new_nodes[(i + 1) % 5];
 
-        edge_l.change_destination(curr_new_node);
-        curr_new_node->set_neighbor_at(4, edge_l.from);
+        G_.set_neighbor_at(edge_l.from, edge_l.index, curr_new_node);
+        G_.set_neighbor_at(curr_new_node, 4, edge_l.from);
 
-        edge_l_inv.change_destination(next_new_node);
-        next_new_node->set_neighbor_at(1, edge_l_inv.from);
+        G_.set_neighbor_at(edge_l_inv.from, edge_l_inv.index, next_new_node);
+        G_.set_neighbor_at(next_new_node, 1, edge_l_inv.from);
 
-        edge_r.change_destination(next_new_node);
-        next_new_node->set_neighbor_at(5, edge_r.from);
+        G_.set_neighbor_at(edge_r.from, edge_r.index, next_new_node);
+        G_.set_neighbor_at(next_new_node, 5, edge_r.from);
 
-        edge_r_inv.change_destination(next_new_node);
-        next_new_node->set_neighbor_at(2, edge_r_inv.from);
+        G_.set_neighbor_at(edge_r_inv.from, edge_r_inv.index, next_new_node);
+        G_.set_neighbor_at(next_new_node, 2, edge_r_inv.from);
     }
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "expansions/l_expansion.h"
 #include <expansions/signature_state.h>
+#include <algorithm>
+#include <cstdint>
 #include <queue>
 #include <iostream>
 #include <unordered_set>
@@ -16,36 +18,94 @@ void build_l_rails(const dual_fullerene& G,
     parallel_path.resize(len);
     auto e = start;
     for (int k = 0; k < len; ++k) {
-        path[k] = (int)e.from->id();
-        auto e_inverse = e.inverse();
-        auto side = clockwise ? e_inverse.prev_around() : e_inverse.next_around();
-        parallel_path[k] = (int)side.to()->id();
-        e = clockwise ? e.right_turn(3) : e.left_turn(3);
+        path[k] = (int)e.from;
+        auto e_inverse = G.inverse(e);
+        auto side = clockwise ? G.prev_around(e_inverse) : G.next_around(e_inverse);
+        parallel_path[k] = (int)G.to(side);
+        e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
     }
 }
 
-std::vector<l_expansion_candidate> find_l_candidates(const dual_fullerene& G, int length) {
-    std::vector<l_expansion_candidate> out;
+namespace {
+
+    // Walks the rails from one pentagon edge once, as far as the longest length asks for, and calls
+    // emit(length, path, parallel_path) for every length from min_length on at which they form an L candidate.
+    // Rails of one length are the prefixes of the longer ones, so the walk stops at the first vertex it meets
+    // twice: no longer candidate has unique patch nodes. `seen` is all zero before and after.
+    template<typename Emit>
+    void walk_l_rails(const dual_fullerene& G, const directed_edge& start, const bool clockwise, const int min_length,
+        const int max_length, std::vector<std::uint8_t>& seen, std::vector<int>& path, std::vector<int>& parallel_path,
+        Emit&& emit)
+    {
+        path.clear();
+        parallel_path.clear();
+        auto e = start;
+        for (int k = 0; k < max_length + 3; ++k) {
+            const auto u = e.from;
+            if (seen[u]) {
+                break;
+            }
+            seen[u] = 1;
+            path.push_back(static_cast<int>(u));
 
-    for (const auto& node : G.get_nodes_5()) {
-        for (int i = 0; i < node->degree(); ++i) {
-            directed_edge e{ node, static_cast<std::size_t>(i) };
+            const auto e_inverse = G.inverse(e);
+            const auto w = G.to(clockwise ? G.prev_around(e_inverse) : G.next_around(e_inverse));
+            if (seen[w]) {
+                break;
+            }
+            seen[w] = 1;
+            parallel_path.push_back(static_cast<int>(w));
 
-            for (bool clockwise : { true, false }) {
-                std::vector<int> P, Q;
-                build_l_rails(G, e, clockwise, length, P, Q);
+            const int length = k - 2;
+            if (length >= min_length && G.degree(w) == 5) {
+                emit(length, path, parallel_path);
+            }
+            e = clockwise ? G.right_turn(e, 3) : G.left_turn(e, 3);
+        }
+        for (const int v : path) seen[v] = 0;
+        for (const int v : parallel_path) seen[v] = 0;
+    }
 
-                if ((G.get_node(static_cast<unsigned>(Q[Q.size() - 1]))->degree() == 5) && patch_nodes_unique(P, Q))
-                    out.push_back({ e, clockwise, std::move(P), std::move(Q), length });
+    template<typename Emit>
+    void for_each_l_candidate(const dual_fullerene& G, const int min_length, const int max_length, Emit&& emit)
+    {
+        std::vector<std::uint8_t> seen(G.total_nodes(), 0);
+        std::vector<int> P, Q;
+        P.reserve(max_length + 3);
+        Q.reserve(max_length + 3);
+
+        for (const auto node : G.get_nodes_5()) {
+            for (std::uint32_t i = 0; i < G.degree(node); ++i) {
+                directed_edge e{ node, i };
+
+                for (bool clockwise : { true, false }) {
+                    walk_l_rails(G, e, clockwise, min_length, max_length, seen, P, Q,
+                        [&](const int length, const std::vector<int>& path, const std::vector<int>& parallel_path) {
+                            emit(l_expansion_candidate{ { e, clockwise, path, parallel_path }, length });
+                        });
+                }
             }
         }
     }
 
+}
+
+std::vector<l_expansion_candidate> find_l_candidates(const dual_fullerene& G, int length) {
+    std::vector<l_expansion_candidate> out;
+    for_each_l_candidate(G, length, length, [&](l_expansion_candidate&& c) { out.push_back(std::move(c)); });
+    return out;
+}
+
+std::vector<std::vector<l_expansion_candidate>> find_l_candidates_up_to(const dual_fullerene& G, int max_length) {
+    std::vector<std::vector<l_expansion_candidate>> out(std::max(max_length + 1, 0));
+    for_each_l_candidate(G, 0, max_length, [&](l_expansion_candidate&& c) {
+        out[c.length].push_back(std::move(c));
+    });
     return out;
 }
 
 bool l_expansion::validate() const {
-    return G_.get_node(static_cast<unsigned>(cand_.parallel_path[cand_.parallel_path.size() - 1]))->degree() == 5;
+    return G_.degree(static_cast<unsigned>(cand_.parallel_path[cand_.parallel_path.size() - 1])) == 5;
 }
 
 void l_expansion::apply() {
@@ -58,29 +118,22 @@ void l_expansion::apply() {
 
     // first external hexagon
     const int h1 = G_.add_vertex(node_type::NODE_6);
-    auto h1_node = G_.get_node(h1);
-    
-    G_.move_neighborhood(u0, h1);
 
-    auto u0_node = G_.get_node(u0);;
-    auto u1_node = G_.get_node(u1);
-    auto w0_node = G_.get_node(w0);
-    auto w1_node = G_.get_node(w1);
-    
+    G_.move_neighborhood(u0, h1);
 
     if (c.clockwise) {
         G_.add_neighbor_after(h1, u1, u0);
-        u0_node->add_neighbor(u1_node);
-        u0_node->add_neighbor(w1_node);
-        u0_node->add_neighbor(w0_node);
-        u0_node->add_neighbor(h1_node);
+        G_.add_neighbor(u0, u1);
+        G_.add_neighbor(u0, w1);
+        G_.add_neighbor(u0, w0);
+        G_.add_neighbor(u0, h1);
     }
     else {
         G_.add_neighbor_before(h1, u1, u0);
-        u0_node->add_neighbor(h1_node);
-        u0_node->add_neighbor(w0_node);
-        u0_node->add_neighbor(w1_node);
-        u0_node->add_neighbor(u1_node);
+        G_.add_neighbor(u0, h1);
+        G_.add_neighbor(u0, w0);
+        G_.add_neighbor(u0, w1);
+        G_.add_neighbor(u0, u1);
     }
 
     G_.replace_neighbor(u1, w0, u0);
@@ -96,34 +149,26 @@ void l_expansion::apply() {
         int u_second = c.path[j + 2];
         int w_first = c.parallel_path[j + 1];
         int w_second = c.parallel_path[j + 2];
-        auto u_first_node = G_.get_node(u_first);
-        auto u_second_node = G_.get_node(u_second);
-        auto w_first_node = G_.get_node(w_first);
-        auto w_second_node = G_.get_node(w_second);
-        auto corridor_node = G_.get_node(corridor_v);
-        auto h_node = G_.get_node(h);
-        h_node->clear_neighbors();
-
 
         if (c.clockwise) {
             G_.add_neighbor_after(corridor_v, u_first, h);
-            h_node->add_neighbor(w_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(w_second_node);
+            G_.add_neighbor(h, w_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, w_second);
         }
         else {
             G_.add_neighbor_before(corridor_v, u_first, h);
-            h_node->add_neighbor(w_second_node);
-            h_node->add_neighbor(u_second_node);
-            h_node->add_neighbor(u_first_node);
-            h_node->add_neighbor(corridor_node);
-            h_node->add_neighbor(w_first_node);
+            G_.add_neighbor(h, w_second);
+            G_.add_neighbor(h, u_second);
+            G_.add_neighbor(h, u_first);
+            G_.add_neighbor(h, corridor_v);
+            G_.add_neighbor(h, w_first);
         }
 
         if (j == 0) {
-            inv_first_ = corridor_node->get_edge(h_node);
+            inv_first_ = G_.get_edge_to(corridor_v, h);
         }
         
         G_.replace_neighbor(u_first, w_first, h);
@@ -136,183 +181,195 @@ void l_expansion::apply() {
 
     // second external hexagon
     const int h2 = G_.add_vertex(node_type::NODE_6);
-    auto h2_node = G_.get_node(h2);
     int u_first = c.path[i + 1];
     int u_second = c.path[i + 2];
     int w_first = c.parallel_path[i + 1];
     int w_second = c.parallel_path[i + 2];
-    auto u_first_node = G_.get_node(u_first);
-    auto u_second_node = G_.get_node(u_second);
-    auto w_first_node = G_.get_node(w_first);
-    auto w_second_node = G_.get_node(w_second);
-    auto corridor_node = G_.get_node(corridor_v);
 
     G_.move_neighborhood(w_second, h2);
 
     if (c.clockwise) {
         G_.add_neighbor_after(corridor_v, u_first, w_second);
         G_.add_neighbor_after(h2, w_first, w_second);
-        w_second_node->add_neighbor(w_first_node);
-        w_second_node->add_neighbor(corridor_node);
-        w_second_node->add_neighbor(u_first_node);
-        w_second_node->add_neighbor(u_second_node);
-        w_second_node->add_neighbor(h2_node);
+        G_.add_neighbor(w_second, w_first);
+        G_.add_neighbor(w_second, corridor_v);
+        G_.add_neighbor(w_second, u_first);
+        G_.add_neighbor(w_second, u_second);
+        G_.add_neighbor(w_second, h2);
     }
     else {
         G_.add_neighbor_before(corridor_v, u_first, w_second);
         G_.add_neighbor_before(h2, w_first, w_second);
-        w_second_node->add_neighbor(h2_node);
-        w_second_node->add_neighbor(u_second_node);
-        w_second_node->add_neighbor(u_first_node);
-        w_second_node->add_neighbor(corridor_node);
-        w_second_node->add_neighbor(w_first_node);
+        G_.add_neighbor(w_second, h2);
+        G_.add_neighbor(w_second, u_second);
+        G_.add_neighbor(w_second, u_first);
+        G_.add_neighbor(w_second, corridor_v);
+        G_.add_neighbor(w_second, w_first);
     }
 
     if (i == 0) {
-        inv_first_ = corridor_node->get_edge(w_second_node);
+        inv_first_ = G_.get_edge_to(corridor_v, w_second);
     }
-    inv_second_ = w_second_node->get_edge(corridor_node);
+    inv_second_ = G_.get_edge_to(w_second, corridor_v);
     G_.replace_neighbor(u_first, w_first, w_second);
     G_.replace_neighbor(u_second, w_first, w_second);
     G_.replace_neighbor(w_first, u_second, w_second);
 }
 
-std::vector<std::unique_ptr<base_expansion>>
-find_l_expansions(dual_fullerene& G, int length)
-{
-    std::vector<std::unique_ptr<base_expansion>> out;
+namespace {
 
-    const auto candidates = find_l_candidates(G,length);
-    std::size_t n = candidates.size();
-    if (n == 0) {
-        return out;
-    }
+    // appends an expansion for one candidate of each group that the signatures can't tell apart
+    void append_l_representatives(dual_fullerene& G, const std::vector<l_expansion_candidate>& candidates,
+        std::vector<std::unique_ptr<base_expansion>>& out)
+    {
+        std::size_t n = candidates.size();
+        if (n == 0) {
+            return;
+        }
 
-    std::vector<signature_state> states;
-    states.reserve(n);
-    for (const auto& c : candidates) {
-        states.emplace_back(G, c);
-    }
+        std::vector<signature_state> states;
+        states.reserve(n);
+        for (const auto& c : candidates) {
+            states.emplace_back(G, c);
+        }
 
-    struct Group {
-        std::vector<std::size_t> members;
-        std::size_t prefix_len;
-    };
+        struct Group {
+            std::vector<std::size_t> members;
+            std::size_t prefix_len;
+        };
 
-    std::queue<Group> groups;
-    Group initial;
-    initial.members.reserve(n);
-    for (std::size_t i = 0; i < n; ++i) {
-        initial.members.push_back(i);
-    }
-    initial.prefix_len = 0;
-    groups.push(initial);
+        std::queue<Group> groups;
+        Group initial;
+        initial.members.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            initial.members.push_back(i);
+        }
+        initial.prefix_len = 0;
+        groups.push(initial);
 
-    std::vector<bool> is_representative(n, false);
+        std::vector<bool> is_representative(n, false);
 
-    while (!groups.empty()) {
-        Group g = groups.front();
-        groups.pop();
+        while (!groups.empty()) {
+            Group g = groups.front();
+            groups.pop();
 
-        if (g.members.empty()) {
-            continue;
-        }
+            if (g.members.empty()) {
+                continue;
+            }
 
-        if (g.members.size() == 1) {
-            std::size_t idx = g.members.front();
-            if (!is_representative[idx]) {
-                is_representative[idx] = true;
+            if (g.members.size() == 1) {
+                std::size_t idx = g.members.front();
+                if (!is_representative[idx]) {
+                    is_representative[idx] = true;
+                }
+                continue;
             }
-            continue;
-        }
 
-        for (std::size_t idx : g.members) {
-            states[idx].extend_step();
-        }
+            for (std::size_t idx : g.members) {
+                states[idx].extend_step();
+            }
 
-        std::vector<std::vector<std::size_t>> subgroups;
-        std::vector<std::size_t> reps;
+            std::vector<std::vector<std::size_t>> subgroups;
+            std::vector<std::size_t> reps;
 
-        for (std::size_t idx : g.members) {
-            const auto& sig = states[idx].signature();
+            for (std::size_t idx : g.members) {
+                const auto& sig = states[idx].signature();
 
-            bool placed = false;
-            for (std::size_t k = 0; k < reps.size(); ++k) {
-                std::size_t rep_idx = reps[k];
-                const auto& rep_sig = states[rep_idx].signature();
+                bool placed = false;
+                for (std::size_t k = 0; k < reps.size(); ++k) {
+                    std::size_t rep_idx = reps[k];
+                    const auto& rep_sig = states[rep_idx].signature();
 
-                if (sig.size() != rep_sig.size()) {
-                    continue;
-                }
+                    if (sig.size() != rep_sig.size()) {
+                        continue;
+                    }
+
+                    bool equal = true;
+                    std::size_t start = g.prefix_len;
+                    std::size_t end = sig.size();
+                    for (std::size_t p = start; p < end; ++p) {
+                        if (sig[p] != rep_sig[p]) {
+                            equal = false;
+                            break;
+                        }
+                    }
 
-                bool equal = true;
-                std::size_t start = g.prefix_len;
-                std::size_t end = sig.size();
-                for (std::size_t p = start; p < end; ++p) {
-                    if (sig[p] != rep_sig[p]) {
-                        equal = false;
+                    if (equal) {
+                        subgroups[k].push_back(idx);
+                        placed = true;
                         break;
                     }
                 }
 
-                if (equal) {
-                    subgroups[k].push_back(idx);
-                    placed = true;
-                    break;
+                if (!placed) {
+                    reps.push_back(idx);
+                    subgroups.push_back(std::vector<std::size_t>{idx});
                 }
             }
 
-            if (!placed) {
-                reps.push_back(idx);
-                subgroups.push_back(std::vector<std::size_t>{idx});
-            }
-        }
-
-        for (std::size_t k = 0; k < subgroups.size(); ++k) {
-            auto& members = subgroups[k];
-            if (members.empty()) {
-                continue;
-            }
+            for (std::size_t k = 0; k < subgroups.size(); ++k) {
+                auto& members = subgroups[k];
+                if (members.empty()) {
+                    continue;
+                }
 
-            if (members.size() == 1) {
-                std::size_t idx = members.front();
-                if (!is_representative[idx]) {
-                    is_representative[idx] = true;
+                if (members.size() == 1) {
+                    std::size_t idx = members.front();
+                    if (!is_representative[idx]) {
+                        is_representative[idx] = true;
+                    }
+                    continue;
                 }
-                continue;
-            }
 
-            bool all_finished = true;
-            for (std::size_t idx : members) {
-                if (!states[idx].finished()) {
-                    all_finished = false;
-                    break;
+                bool all_finished = true;
+                for (std::size_t idx : members) {
+                    if (!states[idx].finished()) {
+                        all_finished = false;
+                        break;
+                    }
                 }
-            }
 
-            if (all_finished) {
-                std::size_t idx = members.front();
-                if (!is_representative[idx]) {
-                    is_representative[idx] = true;
+                if (all_finished) {
+                    std::size_t idx = members.front();
+                    if (!is_representative[idx]) {
+                        is_representative[idx] = true;
+                    }
+                }
+                else {
+                    Group ng;
+                    ng.members = std::move(members);
+                    ng.prefix_len = states[reps[k]].signature().size();
+                    groups.push(std::move(ng));
                 }
-            }
-            else {
-                Group ng;
-                ng.members = std::move(members);
-                ng.prefix_len = states[reps[k]].signature().size();
-                groups.push(std::move(ng));
             }
         }
-    }
 
-    for (std::size_t i = 0; i < n; ++i) {
-        if (is_representative[i]) {
-            auto e = std::make_unique<l_expansion>(G, candidates[i]);
-            if (e->validate()) {
-                out.push_back(std::move(e));
+        for (std::size_t i = 0; i < n; ++i) {
+            if (is_representative[i]) {
+                auto e = std::make_unique<l_expansion>(G, candidates[i]);
+                if (e->validate()) {
+                    out.push_back(std::move(e));
+                }
             }
         }
     }
 
+}
+
+std::vector<std::unique_ptr<base_expansion>>
+find_l_expansions(dual_fullerene& G, int length)
+{
+    std::vector<std::unique_ptr<base_expansion>> out;
+    append_l_representatives(G, find_l_candidates(G, length), out);
+    return out;
+}
+
+std::vector<std::unique_ptr<base_expansion>>
+find_l_expansions_up_to(dual_fullerene& G, int max_length)
+{
+    std::vector<std::unique_ptr<base_expansion>> out;
+    for (const auto& candidates : find_l_candidates_up_to(G, max_length)) {
+        append_l_representatives(G, candidates, out);
+    }
     return out;
 }
@@ -0,0 +1,208 @@
+#include <expansions/reduction_catalogue.h>
+
+#include <algorithm>
+#include <limits>
+
+void find_reductions_at(const dual_fullerene& G, const unsigned int pentagon, const int min_x0, const int max_x0,
+    std::vector<l_reduction>& l, std::vector<b_reduction>& b)
+{
+    for (int i = 0; i < static_cast<int>(G.degree(pentagon)); ++i) {
+        const directed_edge e0{ pentagon, static_cast<std::uint32_t>(i) };
+
+        for (const bool use_next : { true, false }) {
+            const auto turn = [&](const directed_edge e, const unsigned int which) {
+                return use_next ? G.right_turn(e, which) : G.left_turn(e, which);
+            };
+            const auto outside_hex1 = use_next ? G.degree(G.to(G.prev_around(e0, 2))) : G.degree(G.to(G.next_around(e0, 2)));
+            if (outside_hex1 != 6) continue;
+
+            // e leaves the k-th vertex of the straight ray, prev the one before
+            auto e = e0;
+            for (int k = 1; k <= max_x0; ++k) {
+                const auto prev = e;
+                e = turn(e, 3);
+                const auto v = e.from;
+
+                // the ray ends at its first pentagon, in an L reduction of size k
+                if (G.type(v) == node_type::NODE_5) {
+                    const auto outside_hex2 = use_next ? G.degree(G.to(G.next_around(e, 1))) : G.degree(G.to(G.prev_around(e, 1)));
+                    if (k >= min_x0 && outside_hex2 == 6) {
+                        l_reduction r;
+                        r.first_edge = e0;
+                        r.second_edge = G.get_edge_to(v, prev.from);
+                        r.use_next = use_next;
+                        r.size = k;
+                        l.push_back(r);
+                    }
+                    break;
+                }
+
+                // a B reduction runs k - 1 hexagons straight, bends at the hexagon v and runs straight to a pentagon
+                const int pre = k - 1;
+                auto bent = turn(prev, 2);
+                for (int post = 0; pre + post + 2 <= max_x0; ++post) {
+                    const auto next = turn(bent, 3);
+                    if (G.type(next.from) == node_type::NODE_5) {
+                        if (pre + post + 2 < min_x0) {
+                            break;
+                        }
+                        b_reduction r;
+                        r.first_edge = e0;
+                        r.second_edge = G.get_edge_to(next.from, bent.from);
+                        r.length_pre_bend = pre;
+                        r.length_post_bend = post;
+                        r.use_next = use_next;
+                        b.push_back(r);
+                        break;
+                    }
+                    bent = next;
+                }
+            }
+        }
+    }
+}
+
+void reduction_catalogue::reset()
+{
+    for (auto& b : buckets_) {
+        b.depth = -1;
+    }
+    base_ = nullptr;
+}
+
+void reduction_catalogue::reset(reduction_catalogue& base, const std::size_t mark, const int max_x0)
+{
+    reset();
+    base_ = &base;
+
+    // breadth first from the changed vertices, as far as the largest x0 can reach
+    constexpr auto FAR = std::numeric_limits<std::uint32_t>::max();
+    const auto radius = static_cast<std::uint32_t>(std::max(max_x0, 0)) + 1;
+    const auto n = G_.total_nodes();
+    distance_.assign(n, FAR);
+    queue_.clear();
+    G_.for_each_changed_since(mark, [&](const unsigned int v) {
+        // removed vertices changed the rows of their old neighbours too
+        if (v < n && distance_[v] == FAR) {
+            distance_[v] = 0;
+            queue_.push_back(v);
+        }
+    });
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        const auto v = queue_[head];
+        if (distance_[v] == radius) {
+            continue;
+        }
+        for (std::size_t i = 0; i < G_.degree(v); ++i) {
+            const auto u = G_.neighbor_at(v, i);
+            if (distance_[u] == FAR) {
+                distance_[u] = distance_[v] + 1;
+                queue_.push_back(u);
+            }
+        }
+    }
+
+    for (const auto p : G_.get_nodes_5()) {
+        patch_distance_[p] = std::min(distance_[p], radius + 1);
+    }
+}
+
+const reduction_catalogue::bucket& reduction_catalogue::bucket_(const unsigned int pentagon, const int x0)
+{
+    auto& own = buckets_[pentagon];
+    if (own.depth >= x0) {
+        return own;
+    }
+    // nothing the reductions read changed, the base's bucket is this graph's too
+    if (base_ != nullptr && patch_distance_[pentagon] > static_cast<std::uint32_t>(x0) + 1) {
+        return base_->bucket_(pentagon, x0);
+    }
+
+    // only the sizes not enumerated yet
+    const int from = own.depth + 1;
+    found_l_.clear();
+    found_b_.clear();
+    find_reductions_at(G_, pentagon, from, x0, found_l_, found_b_);
+
+    if (static_cast<int>(own.l.size()) <= x0) {
+        own.l.resize(x0 + 1);
+        own.b.resize(x0 + 1);
+    }
+    for (int x = from; x <= x0; ++x) {
+        own.l[x].clear();
+        own.b[x].resize(std::max(x - 1, 0));
+        for (auto& by_pre : own.b[x]) {
+            by_pre.clear();
+        }
+    }
+    for (const auto& r : found_l_) {
+        own.l[r.size].push_back(r);
+    }
+    for (const auto& r : found_b_) {
+        own.b[r.x0()][r.length_pre_bend].push_back(r);
+    }
+
+    own.depth = x0;
+    return own;
+}
+
+const std::vector<l_reduction>& reduction_catalogue::l_reductions(const int size)
+{
+    l_all_.clear();
+    for (const auto p : G_.get_nodes_5()) {
+        const auto& ls = bucket_(p, size).l[size];
+        l_all_.insert(l_all_.end(), ls.begin(), ls.end());
+    }
+    return l_all_;
+}
+
+const std::vector<b_reduction>& reduction_catalogue::b_reductions(const int length_pre_bend, const int length_post_bend)
+{
+    const int x0 = length_pre_bend + length_post_bend + 2;
+    b_all_.clear();
+    for (const auto p : G_.get_nodes_5()) {
+        const auto& bs = bucket_(p, x0).b[x0][length_pre_bend];
+        b_all_.insert(b_all_.end(), bs.begin(), bs.end());
+    }
+    return b_all_;
+}
+
+bool reduction_catalogue::has_reductions(const int x0)
+{
+    for (const auto p : G_.get_nodes_5()) {
+        const auto& b = bucket_(p, x0);
+        if (!b.l[x0].empty() || std::ranges::any_of(b.b[x0], [](const auto& bs) { return !bs.empty(); })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void reduction_catalogue::collect(const int x0, const int skip_pent, const int skip_index, const bool skip_clockwise,
+    const int skip_l1, std::vector<const base_reduction*>& out)
+{
+    const auto skipped = [&](const base_reduction& r) {
+        return static_cast<int>(r.first_edge.from) == skip_pent && static_cast<int>(r.first_edge.index) == skip_index
+            && r.use_next == skip_clockwise;
+    };
+
+    // an L reduction is only skipped for an L reference, a B reduction only for one bent like the reference
+    for (const auto p : G_.get_nodes_5()) {
+        for (const auto& r : bucket_(p, x0).l[x0]) {
+            if (skip_l1 < 0 && skipped(r)) {
+                continue;
+            }
+            out.push_back(&r);
+        }
+    }
+    for (int pre = 0; pre <= x0 - 2; ++pre) {
+        for (const auto p : G_.get_nodes_5()) {
+            for (const auto& r : bucket_(p, x0).b[x0][pre]) {
+                if (pre == skip_l1 && skipped(r)) {
+                    continue;
+                }
+                out.push_back(&r);
+            }
+        }
+    }
+}
@@ -18,15 +18,15 @@ signature_state::signature_state(const dual_fullerene& G, const expansion_candid
     bfs_order_.reserve(n);
     base_edges_.reserve(3*n);
 
-    unsigned int from_id = c.start.from->id();
-    unsigned int to_id = c.start.to()->id();
+    unsigned int from_id = c.start.from;
+    unsigned int to_id = G.to(c.start);
 
     bfs_order_.push_back(from_id);
     base_edges_.push_back(c.start);
     index_of_[from_id] = 0;
 
     bfs_order_.push_back(to_id);
-    base_edges_.push_back(c.start.inverse());
+    base_edges_.push_back(G.inverse(c.start));
     index_of_[to_id] = 1;
 
     signature_.push_back(0);
@@ -47,28 +47,26 @@ void signature_state::extend_step() {
     directed_edge base_edge = base_edges_[bfs_front_];
     ++bfs_front_;
 
-    auto v_node = graph_->get_node(v_id);
-    std::size_t deg = v_node->degree();
+    std::size_t deg = graph_->degree(v_id);
     signature_.push_back(static_cast<int>(deg));
 
     directed_edge e = base_edge;
     for (std::size_t k = 0; k < deg; ++k) {
-        auto to_node = e.to();
-        unsigned int nid = to_node->id();
+        unsigned int nid = graph_->to(e);
 
         int idx = index_of_[nid];
         if (idx == -1) {
             int new_idx = static_cast<int>(bfs_order_.size());
             index_of_[nid] = new_idx;
             bfs_order_.push_back(nid);
-            base_edges_.push_back(e.inverse());
-            signature_.push_back(new_idx + color_offset_ + to_node->degree());
+            base_edges_.push_back(graph_->inverse(e));
+            signature_.push_back(new_idx + color_offset_ + graph_->degree(nid));
         }
         else {
             signature_.push_back(idx);
         }
 
-        e = candidate_->clockwise ? e.next_around() : e.prev_around();
+        e = candidate_->clockwise ? graph_->next_around(e) : graph_->prev_around(e);
     }
 
     if (bfs_front_ >= bfs_order_.size()) {
@@ -1,3 +1,4 @@
+#include <climits>
 #include <ranges>
 #include <string>
 #include <stdexcept>
@@ -5,23 +6,22 @@
 #include <fullerene/dual_fullerene.h>
 #include "generators/id_registry.h"
 
-const std::string BASE_FULLERENE_STRING = "BASE";
+namespace {
+    // the parent of the base fullerenes
+    constexpr fullerene_id BASE_FULLERENE_ID{};
+}
 
 dual_fullerene::dual_fullerene(const std::vector<std::vector<unsigned int>>& adjacency) {
     const std::size_t n = adjacency.size();
 
-    std::vector<std::shared_ptr<base_node>> index_to_node(n);
+    reserve(n);
 
     for (std::size_t i = 0; i < n; i++) {
         if (i < 12) {
-            auto p = node_5::create_sized(static_cast<unsigned int>(i));
-            index_to_node[i] = p;
-            nodes_5.push_back(p);
+            add_sized_vertex(node_type::NODE_5);
         }
         else {
-            auto p = node_6::create_sized(static_cast<unsigned int>(i));
-            index_to_node[i] = p;
-            nodes_6.push_back(p);
+            add_sized_vertex(node_type::NODE_6);
         }
     }
 
@@ -56,152 +56,336 @@ dual_fullerene::dual_fullerene(const std::vector<std::vector<unsigned int>>& adj
     }
 
     for (std::size_t i = 0; i < n; ++i) {
-        for (const auto [index, j] : std::ranges::views::enumerate(adjacency[i])) {
-            const auto& a = index_to_node[i];
-            const auto& b = index_to_node[j];
-            a->set_neighbor_at(index, b);
-        }
+        std::ranges::copy(adjacency[i], rotations_[i].begin());
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        refresh_inverse_row_(static_cast<unsigned int>(i));
     }
 }
 
 fullerene dual_fullerene::to_primal() const {
+    fullerene primal;
+    to_primal_into(primal);
+    return primal;
+}
+
+void dual_fullerene::to_primal_into(fullerene& out) const {
     const std::size_t V = total_nodes();
     const std::size_t E = (5 * 12 + 6 * (V - 12)) / 2;
     const std::size_t F = E - V + 2;
 
-    std::vector<std::array<unsigned int, 3>> adjacency(F);
-    std::vector<unsigned int> counts(F, 0);
+    // unfilled neighbor slots of a primal vertex stay UINT_MAX until the second pass reaches them
+    auto& adjacency = out.adjacency_;
+    adjacency.assign(F, { UINT_MAX, UINT_MAX, UINT_MAX });
+    auto& reversed = out.reversed_rows_;
+    reversed.assign(F, 0);
     unsigned int face = 0;
 
-    for_each_node([&](const std::shared_ptr<base_node>& node) {
-        for (int i = 0; i < static_cast<int>(node->degree()); i++) {
-            auto edge = node->get_edge(static_cast<std::size_t>(i));
-            if (edge.data().marked) continue;
+    clear_all_edge_data();
 
-            const auto start_node = edge.from;
+    for_each_node([&](const unsigned int node) {
+        for (std::uint32_t i = 0; i < degree(node); i++) {
+            directed_edge edge{ node, i };
+            if (is_marked(edge)) continue;
 
+            std::uint8_t position = 0;
             do {
-                edge.data().marked = true;
-                edge.data().rhs_face_index = face;
-                edge = edge.right_turn();
-            } while (edge.from != start_node);
+                mark(edge);
+                data(edge).rhs_face_index = face;
+                data(edge).rhs_face_position = position++;
+                edge = right_turn(edge);
+            } while (edge.from != node);
 
             face++;
         }
         });
 
-    for_each_node([&](const std::shared_ptr<base_node>& node) {
-        for (int i = 0; i < static_cast<int>(node->degree()); i++) {
-            auto edge = node->get_edge(static_cast<std::size_t>(i));
+    for_each_node([&](const unsigned int node) {
+        for (std::uint32_t i = 0; i < degree(node); i++) {
+            const directed_edge edge{ node, i };
 
-            const auto u = edge.data().rhs_face_index;
-            const auto v = edge.inverse().data().rhs_face_index;
+            const auto u = data(edge).rhs_face_index;
+            const auto v = data(inverse(edge)).rhs_face_index;
 
-            adjacency[u][counts[u]++] = v;
+            auto& row = adjacency[u];
+            const std::size_t k = row[0] == UINT_MAX ? 0 : row[1] == UINT_MAX ? 1 : 2;
+            row[k] = v;
+
+            // rows fill in vertex order; compare the first two fills with the trace order of the face
+            const auto position = data(edge).rhs_face_position;
+            if (k == 0) {
+                reversed[u] = position;
+            }
+            else if (k == 1) {
+                reversed[u] = (position + 3 - reversed[u]) % 3 == 1 ? 0 : 1;
+            }
         }
         });
 
     const auto outer_face = nodes_5[11];
-    auto outer_face_nodes = std::array<unsigned int, 5>();
 
-    for (int i = 0; i < static_cast<int>(outer_face->degree()); i++) {
-        auto edge = outer_face->get_edge(static_cast<std::size_t>(i));
-        outer_face_nodes[i] = edge.data().rhs_face_index;
+    for (std::uint32_t i = 0; i < degree(outer_face); i++) {
+        out.outer_face_nodes_[i] = data({ outer_face, i }).rhs_face_index;
     }
 
-    clear_all_edge_data();
+    copy_ids_into(out);
+    out.is_ipr_ = is_ipr();
+}
 
-    auto parent_id = BASE_FULLERENE_STRING;
+void dual_fullerene::copy_ids_into(fullerene& out) const {
+    out.id_ = id;
+    out.parent_id_ = get_parent_id();
+}
 
-    if(construction_path.size() > 1) {
-        parent_id = construction_path.at(construction_path.size() - 2);
+std::size_t dual_fullerene::slot_of_(const unsigned int v, const unsigned int n) const {
+    const auto& rotation = rotations_[v];
+    for (std::size_t i = 0; i < degrees_[v]; i++) {
+        if (rotation[i] == n) {
+            return i;
+        }
     }
 
-    return std::move(fullerene(id, parent_id, is_ipr(), adjacency, outer_face_nodes));
+    throw std::invalid_argument("Node " + std::to_string(n) +
+        " is not a neighbor of node " + std::to_string(v));
 }
 
-std::shared_ptr<base_node> dual_fullerene::get_node(unsigned int id) const {
-    for (const auto& n : nodes_5) {
-        if (n->id() == id)
-            return n;
+void dual_fullerene::insert_neighbor_at_(const unsigned int v, const std::size_t index, const unsigned int n) {
+    auto& rotation = rotations_[v];
+    const std::size_t d = degrees_[v];
+
+    if (d == MAX_DEGREE) {
+        throw std::out_of_range("Node " + std::to_string(v) + " already has " +
+            std::to_string(MAX_DEGREE) + " neighbors");
     }
-    for (const auto& n : nodes_6) {
-        if (n->id() == id)
-            return n;
+
+    journal_row_(v);
+    std::copy_backward(rotation.begin() + index, rotation.begin() + d, rotation.begin() + d + 1);
+    rotation[index] = n;
+    degrees_[v] = static_cast<std::uint8_t>(d + 1);
+    // only the inserted slot and the ones shifted behind it moved
+    for (std::size_t i = index; i <= d; i++) {
+        refresh_inverse_slot_(v, i);
     }
+}
 
-    throw std::out_of_range("No node with id " + std::to_string(id));
+void dual_fullerene::erase_neighbor_at_(const unsigned int v, const std::size_t index) {
+    auto& rotation = rotations_[v];
+    const std::size_t d = degrees_[v];
+
+    journal_row_(v);
+    std::copy(rotation.begin() + index + 1, rotation.begin() + d, rotation.begin() + index);
+    rotation[d - 1] = NO_NEIGHBOR;
+    degrees_[v] = static_cast<std::uint8_t>(d - 1);
+    inverse_slots_[v][d - 1] = NO_SLOT;
+    for (std::size_t i = index; i + 1 < d; i++) {
+        refresh_inverse_slot_(v, i);
+    }
 }
 
-void dual_fullerene::clear_all_edge_data() const {
-    for_each_node([](const std::shared_ptr<base_node>& node) {
-        node->clear_all_edge_data();
-        });
+void dual_fullerene::refresh_inverse_slot_(const unsigned int v, const std::size_t index) {
+    const auto n = rotations_[v][index];
+    inverse_slots_[v][index] = NO_SLOT;
+    if (n == NO_NEIGHBOR) {
+        return;
+    }
+
+    const auto& rotation = rotations_[n];
+    for (std::size_t i = 0; i < degrees_[n]; i++) {
+        if (rotation[i] == v) {
+            inverse_slots_[v][index] = static_cast<std::uint8_t>(i);
+            inverse_slots_[n][i] = static_cast<std::uint8_t>(index);
+            return;
+        }
+    }
+}
+
+void dual_fullerene::refresh_inverse_row_(const unsigned int v) {
+    inverse_slots_[v].fill(NO_SLOT);
+    for (std::size_t i = 0; i < degrees_[v]; i++) {
+        refresh_inverse_slot_(v, i);
+    }
+}
+
+int dual_fullerene::push_vertex_(const node_type type, const std::size_t degree) {
+    const auto id = append_vertex_(type, degree);
+
+    if (!checkpoint_serials_.empty()) {
+        journal_.push_back({ journal_op::ADD_VERTEX, type, 0, id, {} });
+    }
+
+    return static_cast<int>(id);
 }
 
-int dual_fullerene::add_vertex(node_type type) {
+unsigned int dual_fullerene::append_vertex_(const node_type type, const std::size_t degree) {
     const auto id = static_cast<unsigned int>(total_nodes());
 
+    if (id < peak_rows_) {
+        ++storage_stats_.recycled_vertices;
+    }
+    else {
+        ++storage_stats_.fresh_vertices;
+        peak_rows_ = id + 1;
+    }
+
+    std::array<std::uint32_t, MAX_DEGREE> rotation;
+    rotation.fill(NO_NEIGHBOR);
+    std::array<std::uint8_t, MAX_DEGREE> inverse_slots;
+    inverse_slots.fill(NO_SLOT);
+
+    rotations_.push_back(rotation);
+    inverse_slots_.push_back(inverse_slots);
+    row_stamps_.push_back(checkpoint_serials_.empty() ? 0 : checkpoint_serials_.back());
+    degrees_.push_back(static_cast<std::uint8_t>(degree));
+    types_.push_back(type);
+    edge_data_.push_back({});
+
     switch (type) {
-        case node_type::NODE_5: {
-            auto p = node_5::create(id);
-            nodes_5.push_back(p);
+        case node_type::NODE_5:
+            nodes_5.push_back(id);
             break;
-        }
-        case node_type::NODE_6: {
-            auto p = node_6::create(id);
-            nodes_6.push_back(p);
+        case node_type::NODE_6:
+            nodes_6.push_back(id);
             break;
-        }
     }
 
-    return static_cast<int>(id);
+    return id;
+}
+
+void dual_fullerene::pop_vertex_() {
+    switch (types_.back()) {
+        case node_type::NODE_5:
+            nodes_5.pop_back();
+            break;
+        case node_type::NODE_6:
+            nodes_6.pop_back();
+            break;
+    }
+
+    rotations_.pop_back();
+    inverse_slots_.pop_back();
+    row_stamps_.pop_back();
+    degrees_.pop_back();
+    types_.pop_back();
+    edge_data_.pop_back();
+}
+
+void dual_fullerene::journal_row_(const unsigned int v) {
+    if (!checkpoint_serials_.empty() && row_stamps_[v] != checkpoint_serials_.back()) {
+        row_stamps_[v] = checkpoint_serials_.back();
+        journal_.push_back({ journal_op::ROW, types_[v], degrees_[v], v, rotations_[v] });
+    }
+}
+
+bool dual_fullerene::is_neighbor_of(const unsigned int v, const unsigned int n) const {
+    const auto& rotation = rotations_[v];
+    return std::find(rotation.begin(), rotation.begin() + degrees_[v], n) != rotation.begin() + degrees_[v];
+}
+
+directed_edge dual_fullerene::get_edge(const unsigned int v, const std::size_t index) const {
+    if (index < degree(v)) {
+        return { v, static_cast<std::uint32_t>(index) };
+    }
+
+    throw std::out_of_range("Node " + std::to_string(v) + " doesn't have a neighbor with index " +
+        std::to_string(index));
+}
+
+directed_edge dual_fullerene::get_edge_to(const unsigned int v, const unsigned int n) const {
+    return { v, static_cast<std::uint32_t>(slot_of_(v, n)) };
+}
+
+void dual_fullerene::clear_all_edge_data() const {
+    if (++edge_epoch_ != 0) {
+        return;
+    }
+
+    for (auto& row : edge_data_) {
+        row.fill({});
+    }
+    edge_epoch_ = 1;
 }
 
+void dual_fullerene::reserve(const std::size_t vertices) {
+    rotations_.reserve(vertices);
+    inverse_slots_.reserve(vertices);
+    row_stamps_.reserve(vertices);
+    degrees_.reserve(vertices);
+    types_.reserve(vertices);
+    edge_data_.reserve(vertices);
+    nodes_5.reserve(12);
+    nodes_6.reserve(vertices > 12 ? vertices - 12 : 0);
+}
+
+int dual_fullerene::add_vertex(const node_type type) {
+    return push_vertex_(type, 0);
+}
+
+int dual_fullerene::add_sized_vertex(const node_type type) {
+    return push_vertex_(type, type == node_type::NODE_5 ? 5 : 6);
+}
+
+void dual_fullerene::add_neighbor(const int v, const int n) {
+    const auto u = static_cast<unsigned int>(v);
+    insert_neighbor_at_(u, degrees_[u], static_cast<unsigned int>(n));
+}
 
 void dual_fullerene::add_neighbor_after(int v, int after, int v2) {
-    auto v_node = get_node(static_cast<unsigned int>(v));
-    auto after_node = get_node(static_cast<unsigned int>(after));
-    auto v2_node = get_node(static_cast<unsigned int>(v2));
-    v_node->add_neighbour_after(after_node, v2_node);
+    const auto u = static_cast<unsigned int>(v);
+    insert_neighbor_at_(u, slot_of_(u, static_cast<unsigned int>(after)) + 1, static_cast<unsigned int>(v2));
 }
 
 void dual_fullerene::add_neighbor_before(int v, int before, int v2) {
-    auto v_node = get_node(static_cast<unsigned int>(v));
-    auto before_node = get_node(static_cast<unsigned int>(before));
-    auto v2_node = get_node(static_cast<unsigned int>(v2));
-    v_node->add_neighbour_before(before_node, v2_node);
+    const auto u = static_cast<unsigned int>(v);
+    insert_neighbor_at_(u, slot_of_(u, static_cast<unsigned int>(before)), static_cast<unsigned int>(v2));
+}
+
+void dual_fullerene::set_neighbor_at(const int v, const std::size_t index, const int n) {
+    const auto u = static_cast<unsigned int>(v);
+    journal_row_(u);
+    rotations_[u][index] = static_cast<unsigned int>(n);
+    refresh_inverse_slot_(u, index);
+}
+
+void dual_fullerene::remove_neighbor(const int v, const int n) {
+    const auto u = static_cast<unsigned int>(v);
+    erase_neighbor_at_(u, slot_of_(u, static_cast<unsigned int>(n)));
 }
 
 void dual_fullerene::remove_edge(int v1, int v2) {
-    auto n1 = get_node(static_cast<unsigned int>(v1));
-    auto n2 = get_node(static_cast<unsigned int>(v2));
-    n1->remove_neighbor(n2);
-    n2->remove_neighbor(n1);
+    remove_neighbor(v1, v2);
+    remove_neighbor(v2, v1);
 }
 
 void dual_fullerene::replace_neighbor(int v, int old_n, int new_n) {
-    auto v_node = get_node(static_cast<unsigned int>(v));
-    auto old_node = get_node(static_cast<unsigned int>(old_n));
-    auto new_node = get_node(static_cast<unsigned int>(new_n));
-    v_node->replace_neighbor(old_node, new_node);
+    const auto u = static_cast<unsigned int>(v);
+    const auto index = slot_of_(u, static_cast<unsigned int>(old_n));
+    journal_row_(u);
+    rotations_[u][index] = static_cast<unsigned int>(new_n);
+    refresh_inverse_slot_(u, index);
 }
 
 void dual_fullerene::move_neighborhood(int from, int to) {
-    auto from_node = get_node(static_cast<unsigned int>(from));
-    auto to_node = get_node(static_cast<unsigned int>(to));
+    const auto f = static_cast<unsigned int>(from);
+    const auto t = static_cast<unsigned int>(to);
 
-    to_node->move_neighborhood_from(from_node);
+    journal_row_(t);
+    rotations_[t] = rotations_[f];
+    degrees_[t] = degrees_[f];
+    clear_neighbors(from);
 
-    for (const auto& w : to_node->neighbors()) {
-        if (auto n = w.lock()) {
-            n->replace_neighbor(from_node, to_node);
-        }
+    for (std::size_t i = 0; i < degrees_[t]; i++) {
+        replace_neighbor(static_cast<int>(rotations_[t][i]), from, to);
     }
+    refresh_inverse_row_(t);
 }
 
-void dual_fullerene::add_node(const std::shared_ptr<node_6>& new_node) {
-    nodes_6.push_back(new_node);
+void dual_fullerene::clear_neighbors(const int v) {
+    const auto u = static_cast<unsigned int>(v);
+    journal_row_(u);
+    rotations_[u].fill(NO_NEIGHBOR);
+    inverse_slots_[u].fill(NO_SLOT);
+    degrees_[u] = 0;
 }
 
 void dual_fullerene::pop_last_node6() {
@@ -209,31 +393,127 @@ void dual_fullerene::pop_last_node6() {
         throw std::out_of_range("pop_last_node6 on empty nodes_6");
     }
 
-    auto victim = nodes_6.back();
-    victim->clear_neighbors();
-    
-    nodes_6.pop_back();
+    if (nodes_6.back() + 1 != total_nodes()) {
+        throw std::logic_error("pop_last_node6: last hexagon is not the last vertex");
+    }
+
+    if (!checkpoint_serials_.empty()) {
+        const auto v = static_cast<unsigned int>(total_nodes() - 1);
+        journal_.push_back({ journal_op::POP_VERTEX, node_type::NODE_6, degrees_[v], v, rotations_[v] });
+    }
+
+    pop_vertex_();
+}
+
+std::size_t dual_fullerene::checkpoint() {
+    checkpoint_serials_.push_back(++next_serial_);
+    return journal_.size();
+}
+
+void dual_fullerene::rollback(const std::size_t mark) {
+    if (checkpoint_serials_.empty() || mark > journal_.size()) {
+        throw std::logic_error("rollback without a matching checkpoint");
+    }
+
+    restored_rows_.clear();
+    while (journal_.size() > mark) {
+        const journal_entry entry = journal_.back();
+        journal_.pop_back();
+
+        switch (entry.op) {
+            case journal_op::ROW:
+                rotations_[entry.v] = entry.rotation;
+                degrees_[entry.v] = entry.degree;
+                restored_rows_.push_back(entry.v);
+                break;
+            case journal_op::ADD_VERTEX:
+                pop_vertex_();
+                break;
+            case journal_op::POP_VERTEX:
+                append_vertex_(entry.type, entry.degree);
+                rotations_[entry.v] = entry.rotation;
+                restored_rows_.push_back(entry.v);
+                break;
+        }
+    }
+
+    for (const auto v : restored_rows_) {
+        if (v < total_nodes()) {
+            refresh_inverse_row_(v);
+        }
+    }
+
+    checkpoint_serials_.pop_back();
+}
+
+void dual_fullerene::clear_journal() {
+    journal_.clear();
+    checkpoint_serials_.clear();
+}
+
+void dual_fullerene::save_snapshot(snapshot& out) const {
+    out.rotations = rotations_;
+    out.degrees = degrees_;
+    out.types = types_;
+    out.id = id;
+    out.parent_id = get_parent_id();
+}
+
+void dual_fullerene::load_snapshot(const snapshot& in) {
+    const std::size_t V = in.rotations.size();
+
+    rotations_ = in.rotations;
+    degrees_ = in.degrees;
+    types_ = in.types;
+    inverse_slots_.resize(V);
+    edge_data_.resize(V);
+    row_stamps_.assign(V, 0);
+    peak_rows_ = std::max(peak_rows_, V);
+    clear_journal();
+
+    nodes_5.clear();
+    nodes_6.clear();
+    for (unsigned int v = 0; v < V; v++) {
+        (types_[v] == node_type::NODE_5 ? nodes_5 : nodes_6).push_back(v);
+    }
+    for (unsigned int v = 0; v < V; v++) {
+        refresh_inverse_row_(v);
+    }
+
+    id = in.id;
+    construction_path.resize(2);
+    construction_path[0] = in.parent_id;
+    construction_path[1] = in.id;
 }
 
-void dual_fullerene::register_id() {
+void dual_fullerene::register_id(const std::uint32_t scope) {
     const std::size_t V = total_nodes();
     const std::size_t E = (5 * 12 + 6 * (V - 12)) / 2;
     const std::size_t F = E - V + 2;
 
-    auto new_id = id_registry::register_id(F);
+    assign_id(id_registry::register_id(static_cast<std::uint32_t>(F), scope));
+}
 
+void dual_fullerene::assign_id(const fullerene_id& new_id) {
     id = new_id;
     construction_path.push_back(new_id);
 }
 
+const fullerene_id& dual_fullerene::get_parent_id() const noexcept {
+    if (construction_path.size() > 1) {
+        return construction_path[construction_path.size() - 2];
+    }
+    return BASE_FULLERENE_ID;
+}
+
 void dual_fullerene::reduce_id() {
     construction_path.pop_back();
 }
 
 bool dual_fullerene::is_ipr() const {
-    for(auto u: nodes_5) {
-        for(auto v: u->neighbors()) {
-            if(v.lock()->type() == node_type::NODE_5) {
+    for (const auto u : nodes_5) {
+        for (std::size_t i = 0; i < degrees_[u]; i++) {
+            if (types_[rotations_[u][i]] == node_type::NODE_5) {
                 return false;
             }
         }
@@ -241,3 +521,40 @@ bool dual_fullerene::is_ipr() const {
 
     return true;
 }
+
+bool dual_fullerene::has_pentagon_distance(const unsigned int distance) const {
+    if (distance <= 1) {
+        return true;
+    }
+    if (distance == 2) {
+        return is_ipr();
+    }
+
+    // breadth-first search around every pentagon, up to distance - 1 edges
+    std::vector<unsigned int> reached(total_nodes(), UINT_MAX);
+    std::vector<unsigned int> frontier;
+    std::vector<unsigned int> next;
+    for (const auto source : nodes_5) {
+        frontier.assign(1, source);
+        reached[source] = source;
+        for (unsigned int depth = 1; depth < distance && !frontier.empty(); ++depth) {
+            next.clear();
+            for (const auto u : frontier) {
+                for (std::size_t i = 0; i < degrees_[u]; i++) {
+                    const auto w = rotations_[u][i];
+                    if (reached[w] == source) {
+                        continue;
+                    }
+                    if (types_[w] == node_type::NODE_5) {
+                        return false;
+                    }
+                    reached[w] = source;
+                    next.push_back(w);
+                }
+            }
+            frontier.swap(next);
+        }
+    }
+
+    return true;
+}
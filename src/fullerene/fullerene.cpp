@@ -1,25 +1,60 @@
-﻿#include <ranges>
-#include <sstream>
+﻿#include <charconv>
+#include <limits>
+#include <ostream>
 #include <fullerene/fullerene.h>
 
+namespace {
+    constexpr std::size_t MAX_NUMBER_LENGTH = std::numeric_limits<std::size_t>::digits10 + 1;
+
+    template<typename T>
+    char* put_number(char* out, const T value) {
+        return std::to_chars(out, out + MAX_NUMBER_LENGTH, value).ptr;
+    }
+
+}
+
 std::string fullerene::write_all() const noexcept {
-    std::ostringstream ss;
+    std::string text(max_text_size(), '\0');
+    text.resize(write_text(text.data()) - text.data());
+    return text;
+}
+
+std::size_t fullerene::max_text_size() const noexcept {
+    // header: size, two ids, ipr flag; then the outer face; then three numbers per vertex, each with a separator
+    return 3 * (MAX_NUMBER_LENGTH + 1) + 2 * fullerene_id::MAX_TEXT_SIZE + 2 +
+        outer_face_nodes_.size() * (MAX_NUMBER_LENGTH + 1) + 1 +
+        adjacency_.size() * 3 * (MAX_NUMBER_LENGTH + 1);
+}
 
+char* fullerene::write_text(char* out) const noexcept {
     // fullerene metadata
-    ss << get_size() << " " << id_ << " " << parent_id_ << " " << is_ipr_ << "\n";
+    out = put_number(out, get_size());
+    *out++ = ' ';
+    out = id_.write_text(out);
+    *out++ = ' ';
+    out = parent_id_.write_text(out);
+    *out++ = ' ';
+    *out++ = is_ipr_ ? '1' : '0';
+    *out++ = '\n';
 
     // nodes of the outer face
-    for (unsigned v : outer_face_nodes_) {
-        ss << v << ' ';
+    for (const unsigned v : outer_face_nodes_) {
+        out = put_number(out, v);
+        *out++ = ' ';
     }
-    ss << "\n";
+    *out++ = '\n';
 
     // adjacency of vertices
     for (auto const& adj : adjacency_) {
-        ss << adj[0] << " " << adj[1] << " " << adj[2] << "\n";
+        out = put_number(out, adj[0]);
+        *out++ = ' ';
+        out = put_number(out, adj[1]);
+        *out++ = ' ';
+        out = put_number(out, adj[2]);
+        *out++ = '\n';
     }
 
-    return ss.str();
+    return out;
 }
 
 std::ostream & operator<<(std::ostream &os, const fullerene &f) {
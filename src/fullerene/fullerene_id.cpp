@@ -0,0 +1,65 @@
+#include <fullerene/fullerene_id.h>
+
+#include <charconv>
+#include <cstring>
+
+namespace {
+    constexpr std::string_view BASE_TEXT = "BASE";
+
+    template<typename T>
+    bool parse_number(const std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+}
+
+char* fullerene_id::write_text(char* out) const noexcept {
+    if (is_base()) {
+        std::memcpy(out, BASE_TEXT.data(), BASE_TEXT.size());
+        return out + BASE_TEXT.size();
+    }
+
+    out = std::to_chars(out, out + MAX_TEXT_SIZE, size).ptr;
+    *out++ = ':';
+    if (scope != NO_SCOPE) {
+        out = std::to_chars(out, out + MAX_TEXT_SIZE, scope).ptr;
+        *out++ = '/';
+    }
+    return std::to_chars(out, out + MAX_TEXT_SIZE, ordinal).ptr;
+}
+
+std::string fullerene_id::to_string() const {
+    char text[MAX_TEXT_SIZE];
+    return { text, write_text(text) };
+}
+
+bool fullerene_id::parse(const std::string_view text, fullerene_id& id) {
+    if (text == BASE_TEXT) {
+        id = {};
+        return true;
+    }
+
+    const auto colon = text.find(':');
+    if (colon == std::string_view::npos) {
+        return false;
+    }
+    fullerene_id parsed;
+    if (!parse_number(text.substr(0, colon), parsed.size) || parsed.size == 0) {
+        return false;
+    }
+
+    auto rest = text.substr(colon + 1);
+    const auto slash = rest.find('/');
+    if (slash != std::string_view::npos) {
+        if (!parse_number(rest.substr(0, slash), parsed.scope) || parsed.scope == NO_SCOPE) {
+            return false;
+        }
+        rest = rest.substr(slash + 1);
+    }
+    if (!parse_number(rest, parsed.ordinal)) {
+        return false;
+    }
+
+    id = parsed;
+    return true;
+}
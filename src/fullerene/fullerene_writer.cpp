@@ -0,0 +1,312 @@
+#include <fullerene/fullerene_writer.h>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr std::string_view BINARY_HEADER = ">>fullerene_binary<<";
+    constexpr std::string_view PLANAR_CODE_HEADER = ">>planar_code le<<";
+    constexpr std::string_view DELTA_HEADER = ">>fullerene_delta<<\n";
+    constexpr std::size_t MAX_STEP_TEXT_SIZE = 4 + 5 * 21;
+    constexpr std::size_t MAX_NARROW_SIZE = UINT8_MAX;
+
+    char* put_u8(char* out, const std::size_t value) {
+        *out++ = static_cast<char>(static_cast<std::uint8_t>(value));
+        return out;
+    }
+
+    char* put_u16(char* out, const std::size_t value) {
+        out = put_u8(out, value & 0xFF);
+        return put_u8(out, (value >> 8) & 0xFF);
+    }
+
+    char* put_index(char* out, const std::size_t value, const bool wide) {
+        return wide ? put_u16(out, value) : put_u8(out, value);
+    }
+
+    // an id's text is at most fullerene_id::MAX_TEXT_SIZE bytes, so its length always fits the byte before it
+    char* put_short_id(char* out, const fullerene_id& id) {
+        char* const text = out + 1;
+        out = id.write_text(text);
+        put_u8(text - 1, static_cast<std::size_t>(out - text));
+        return out;
+    }
+
+    char* put_text(char* out, const std::string_view s) {
+        std::memcpy(out, s.data(), s.size());
+        return out + s.size();
+    }
+
+    char* put_field(char* out, const long long value) {
+        *out++ = ' ';
+        return std::to_chars(out, out + 20, value).ptr;
+    }
+
+    char* write_step_text(const expansion_step& step, char* out) {
+        switch (step.type) {
+            case step_type::SEED_C20:
+                return put_text(out, "C20");
+            case step_type::SEED_C28:
+                return put_text(out, "C28");
+            case step_type::SEED_C30:
+                return put_text(out, "C30");
+            case step_type::F:
+                out = put_text(out, "F");
+                return put_field(out, step.start.from);
+            case step_type::L:
+                out = put_text(out, "L");
+                out = put_field(out, step.start.from);
+                out = put_field(out, step.start.index);
+                out = put_field(out, step.clockwise);
+                return put_field(out, step.length_pre_bend);
+            case step_type::B:
+                out = put_text(out, "B");
+                out = put_field(out, step.start.from);
+                out = put_field(out, step.start.index);
+                out = put_field(out, step.clockwise);
+                out = put_field(out, step.length_pre_bend);
+                return put_field(out, step.length_post_bend);
+        }
+        return out;
+    }
+
+    char* write_binary(const fullerene& f, char* out) {
+        const std::size_t n = f.get_size();
+        if (n > UINT16_MAX) {
+            throw std::length_error("Fullerene of size " + std::to_string(n) + " is too large for the binary format");
+        }
+
+        const bool wide = n > MAX_NARROW_SIZE;
+        out = put_u16(out, n);
+        out = put_u8(out, (f.is_ipr() ? 1u : 0u) | (wide ? 2u : 0u));
+        out = put_short_id(out, f.get_id());
+        out = put_short_id(out, f.get_parent_id());
+
+        for (const unsigned v : f.get_outer_face_nodes()) {
+            out = put_index(out, v, wide);
+        }
+        for (const auto& adj : f.get_adjacency_view()) {
+            for (const unsigned v : adj) {
+                out = put_index(out, v, wide);
+            }
+        }
+
+        return out;
+    }
+
+    char* write_planar_code(const fullerene& f, char* out) {
+        const std::size_t n = f.get_size();
+        const bool wide = n > MAX_NARROW_SIZE;
+
+        if (wide) {
+            if (n > UINT16_MAX) {
+                throw std::length_error("Fullerene of size " + std::to_string(n) + " is too large for planar_code");
+            }
+            out = put_u8(out, 0);
+            out = put_u16(out, n);
+        }
+        else {
+            out = put_u8(out, n);
+        }
+
+        for (std::size_t v = 0; v < n; v++) {
+            for (const unsigned u : f.get_rotation(v)) {
+                out = put_index(out, u + 1, wide);
+            }
+            out = put_index(out, 0, wide);
+        }
+
+        return out;
+    }
+}
+
+bool parse_output_format(const std::string_view name, output_format& format) {
+    if (name == "text") {
+        format = output_format::TEXT;
+    }
+    else if (name == "binary") {
+        format = output_format::BINARY;
+    }
+    else if (name == "planar_code") {
+        format = output_format::PLANAR_CODE;
+    }
+    else if (name == "delta") {
+        format = output_format::DELTA;
+    }
+    else if (name == "count") {
+        format = output_format::COUNT;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+std::string_view output_format_name(const output_format format) {
+    switch (format) {
+        case output_format::TEXT:
+            return "text";
+        case output_format::BINARY:
+            return "binary";
+        case output_format::PLANAR_CODE:
+            return "planar_code";
+        case output_format::DELTA:
+            return "delta";
+        case output_format::COUNT:
+            return "count";
+    }
+    return {};
+}
+
+fullerene_writer::fullerene_writer(std::ostream& os, const std::size_t block_size) :
+    fullerene_writer(os, output_format::TEXT, block_size) {}
+
+fullerene_writer::fullerene_writer(std::ostream& os, const output_format format, const std::size_t block_size) :
+    os_(os), format_(format), buffer_(block_size) {
+    std::string_view header;
+    switch (format_) {
+        case output_format::TEXT:
+            break;
+        case output_format::BINARY:
+            header = BINARY_HEADER;
+            break;
+        case output_format::PLANAR_CODE:
+            header = PLANAR_CODE_HEADER;
+            break;
+        case output_format::DELTA:
+            header = DELTA_HEADER;
+            break;
+        case output_format::COUNT:
+            break;
+    }
+
+    reserve_(header.size());
+    std::memcpy(buffer_.data() + used_, header.data(), header.size());
+    used_ += header.size();
+}
+
+fullerene_writer::fullerene_writer(std::ostream& os,
+    const output_format format,
+    const continued_stream continued,
+    const std::size_t block_size) :
+    os_(os), format_(format), buffer_(block_size), flushed_(continued.bytes) {}
+
+fullerene_writer::~fullerene_writer() {
+    flush();
+}
+
+std::size_t fullerene_writer::max_record_size(const fullerene& f) const noexcept {
+    const std::size_t n = f.get_size();
+    switch (format_) {
+        case output_format::BINARY:
+            return 3 + 2 + 2 * fullerene_id::MAX_TEXT_SIZE + (5 + 3 * n) * 2;
+        case output_format::PLANAR_CODE:
+            return 3 + 4 * n * 2;
+        case output_format::TEXT:
+        case output_format::DELTA:
+        default:
+            return f.max_text_size();
+    }
+}
+
+void fullerene_writer::reserve_(const std::size_t bytes) {
+    if (used_ + bytes > buffer_.size()) {
+        flush();
+        if (bytes > buffer_.size()) {
+            buffer_.resize(bytes);
+        }
+    }
+}
+
+void fullerene_writer::write(const fullerene& f) {
+    if (format_ == output_format::COUNT) {
+        count(f.get_size(), f.is_ipr());
+        return;
+    }
+
+    reserve_(max_record_size(f));
+
+    char* out = buffer_.data() + used_;
+    switch (format_) {
+        case output_format::TEXT:
+            out = f.write_text(out);
+            break;
+        case output_format::BINARY:
+            out = write_binary(f, out);
+            break;
+        case output_format::PLANAR_CODE:
+            out = write_planar_code(f, out);
+            break;
+        case output_format::DELTA:
+            throw std::logic_error("Full fullerenes can't be written to a delta stream");
+        case output_format::COUNT:
+            break;
+    }
+
+    used_ = static_cast<std::size_t>(out - buffer_.data());
+}
+
+void fullerene_writer::write_step(const fullerene_id& id, const fullerene_id& parent_id, const expansion_step& step) {
+    if (format_ != output_format::DELTA) {
+        throw std::logic_error("Expansion steps can only be written to a delta stream");
+    }
+
+    reserve_(2 * fullerene_id::MAX_TEXT_SIZE + MAX_STEP_TEXT_SIZE);
+
+    char* out = buffer_.data() + used_;
+    out = id.write_text(out);
+    *out++ = ' ';
+    out = parent_id.write_text(out);
+    *out++ = ' ';
+    out = write_step_text(step, out);
+    *out++ = '\n';
+
+    used_ = static_cast<std::size_t>(out - buffer_.data());
+}
+
+void fullerene_writer::count(const std::size_t atoms, const bool ipr) {
+    if (counts_.size() <= atoms) {
+        counts_.resize(atoms + 1);
+    }
+    counts_[atoms].isomers++;
+    counts_[atoms].ipr += ipr ? 1 : 0;
+}
+
+void fullerene_writer::write_counts() {
+    isomer_count total;
+    for (std::size_t atoms = 0; atoms < counts_.size(); ++atoms) {
+        const auto& count = counts_[atoms];
+        if (count.isomers == 0) {
+            continue;
+        }
+        total.isomers += count.isomers;
+        total.ipr += count.ipr;
+
+        reserve_(3 * 21);
+        char* out = buffer_.data() + used_;
+        out = std::to_chars(out, out + 20, atoms).ptr;
+        out = put_field(out, static_cast<long long>(count.isomers));
+        out = put_field(out, static_cast<long long>(count.ipr));
+        *out++ = '\n';
+        used_ = static_cast<std::size_t>(out - buffer_.data());
+    }
+
+    reserve_(6 + 2 * 21);
+    char* out = buffer_.data() + used_;
+    out = put_text(out, "total");
+    out = put_field(out, static_cast<long long>(total.isomers));
+    out = put_field(out, static_cast<long long>(total.ipr));
+    *out++ = '\n';
+    used_ = static_cast<std::size_t>(out - buffer_.data());
+}
+
+void fullerene_writer::flush() {
+    if (used_ > 0) {
+        os_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+        flushed_ += used_;
+        used_ = 0;
+    }
+    os_.flush();
+}
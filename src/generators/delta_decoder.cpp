@@ -0,0 +1,173 @@
+#include <generators/delta_decoder.h>
+#include <expansions/b_expansion.h>
+#include <expansions/f_expansion.h>
+#include <expansions/l_expansion.h>
+#include <fullerene/construct.h>
+
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr std::string_view DELTA_HEADER = ">>fullerene_delta<<";
+
+    template<typename T>
+    void read_field(std::istream& is, T& value, const fullerene_id& id) {
+        if (!(is >> value)) {
+            throw std::runtime_error("Truncated expansion step in delta record " + id.to_string());
+        }
+    }
+
+    void read_start(std::istream& is, expansion_step& step, const fullerene_id& id) {
+        int clockwise;
+        read_field(is, step.start.from, id);
+        read_field(is, step.start.index, id);
+        read_field(is, clockwise, id);
+        step.clockwise = clockwise != 0;
+    }
+
+    directed_edge checked_start(const dual_fullerene& G, const directed_edge start) {
+        if (start.from >= G.total_nodes()) {
+            throw std::runtime_error("Expansion starts at vertex " + std::to_string(start.from) +
+                " outside of the parent graph");
+        }
+        return G.get_edge(start.from, start.index);
+    }
+}
+
+bool read_delta_header(std::istream& is) {
+    std::string header;
+    return static_cast<bool>(is >> header) && header == DELTA_HEADER;
+}
+
+bool read_delta_record(std::istream& is, delta_record& record) {
+    std::string id;
+    if (!(is >> id)) {
+        return false;
+    }
+    if (!fullerene_id::parse(id, record.id)) {
+        throw std::runtime_error("Malformed id " + id + " in delta record");
+    }
+
+    std::string parent_id;
+    std::string type;
+    if (!(is >> parent_id >> type)) {
+        throw std::runtime_error("Truncated delta record " + id);
+    }
+    if (!fullerene_id::parse(parent_id, record.parent_id)) {
+        throw std::runtime_error("Malformed parent id " + parent_id + " in delta record " + id);
+    }
+
+    record.step = {};
+    if (type == "C20") {
+        record.step.type = step_type::SEED_C20;
+    }
+    else if (type == "C28") {
+        record.step.type = step_type::SEED_C28;
+    }
+    else if (type == "C30") {
+        record.step.type = step_type::SEED_C30;
+    }
+    else if (type == "F") {
+        record.step.type = step_type::F;
+        read_field(is, record.step.start.from, record.id);
+    }
+    else if (type == "L") {
+        record.step.type = step_type::L;
+        read_start(is, record.step, record.id);
+        read_field(is, record.step.length_pre_bend, record.id);
+    }
+    else if (type == "B") {
+        record.step.type = step_type::B;
+        read_start(is, record.step, record.id);
+        read_field(is, record.step.length_pre_bend, record.id);
+        read_field(is, record.step.length_post_bend, record.id);
+    }
+    else {
+        throw std::runtime_error("Unknown expansion step '" + type + "' in delta record " + id);
+    }
+
+    return true;
+}
+
+void delta_decoder::apply_step(dual_fullerene& G, const expansion_step& step) {
+    switch (step.type) {
+        case step_type::F: {
+            if (step.start.from >= G.total_nodes()) {
+                throw std::runtime_error("F expansion of vertex " + std::to_string(step.start.from) +
+                    " outside of the parent graph");
+            }
+            f_expansion expansion(G, step.start.from);
+            if (!expansion.validate()) {
+                throw std::runtime_error("The F expansion can't be performed");
+            }
+            expansion.apply();
+            break;
+        }
+        case step_type::L: {
+            l_expansion_candidate cand;
+            cand.start = checked_start(G, step.start);
+            cand.clockwise = step.clockwise;
+            cand.length = step.length_pre_bend;
+            build_l_rails(G, cand.start, cand.clockwise, cand.length, cand.path, cand.parallel_path);
+
+            l_expansion expansion(G, std::move(cand));
+            if (!expansion.validate()) {
+                throw std::runtime_error("The L expansion can't be performed");
+            }
+            expansion.apply();
+            break;
+        }
+        case step_type::B: {
+            b_expansion_candidate cand;
+            cand.start = checked_start(G, step.start);
+            cand.clockwise = step.clockwise;
+            cand.length_pre_bend = step.length_pre_bend;
+            cand.length_post_bend = step.length_post_bend;
+            build_b_rails(G, cand.start, cand.clockwise, cand.length_pre_bend, cand.length_post_bend,
+                cand.path, cand.parallel_path);
+
+            b_expansion expansion(G, std::move(cand));
+            if (!expansion.validate()) {
+                throw std::runtime_error("The B expansion can't be performed");
+            }
+            expansion.apply();
+            break;
+        }
+        default:
+            throw std::logic_error("Base fullerenes are not expansions");
+    }
+}
+
+const dual_fullerene& delta_decoder::decode(const delta_record& record) {
+    switch (record.step.type) {
+        case step_type::SEED_C20:
+            ancestors_.clear();
+            ancestors_.push_back(create_c20_fullerene());
+            break;
+        case step_type::SEED_C28:
+            ancestors_.clear();
+            ancestors_.push_back(create_c28_fullerene());
+            break;
+        case step_type::SEED_C30:
+            ancestors_.clear();
+            ancestors_.push_back(create_c30_fullerene());
+            break;
+        default: {
+            while (!ancestors_.empty() && ancestors_.back().get_id() != record.parent_id) {
+                ancestors_.pop_back();
+            }
+            if (ancestors_.empty()) {
+                throw std::runtime_error("Parent " + record.parent_id.to_string() + " of " + record.id.to_string() +
+                    " is not an ancestor of the previous record");
+            }
+
+            auto child = ancestors_.back();
+            apply_step(child, record.step);
+            ancestors_.push_back(std::move(child));
+            break;
+        }
+    }
+
+    ancestors_.back().assign_id(record.id);
+    return ancestors_.back();
+}
@@ -0,0 +1,107 @@
+#include <generators/emit_pipeline.h>
+#include <generators/backoff.h>
+#include <fullerene/construct.h>
+
+#include <utility>
+
+emit_pipeline::emit_pipeline(fullerene_writer& out, const std::size_t capacity) :
+    out_(out), slots_(capacity == 0 ? 1 : capacity) {
+    thread_ = std::thread([this] { run_(); });
+}
+
+emit_pipeline::~emit_pipeline() {
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+void emit_pipeline::run_() {
+    // graphs are rebuilt into one scratch graph and one primal, so steady state output allocates nothing
+    auto G = create_c20_fullerene();
+    fullerene primal;
+    const bool delta = out_.get_format() == output_format::DELTA;
+    backoff idle;
+
+    while (true) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            // the last pushes may land between the check and the stop request, so look once more after it
+            if (stopping_.load(std::memory_order_acquire) && head == tail_.load(std::memory_order_acquire)) {
+                return;
+            }
+            idle.pause();
+            continue;
+        }
+        idle.reset();
+
+        const auto& s = slots_[head % slots_.size()];
+        if (!failed_.load(std::memory_order_relaxed)) {
+            try {
+                if (delta) {
+                    out_.write_step(s.graph.id, s.graph.parent_id, s.step);
+                }
+                else {
+                    G.load_snapshot(s.graph);
+                    G.to_primal_into(primal);
+                    out_.write(primal);
+                }
+            } catch (...) {
+                error_ = std::current_exception();
+                failed_.store(true, std::memory_order_release);
+            }
+        }
+        head_.store(head + 1, std::memory_order_release);
+    }
+}
+
+void emit_pipeline::rethrow_if_failed_() {
+    if (failed_.load(std::memory_order_acquire)) {
+        std::rethrow_exception(error_);
+    }
+}
+
+emit_pipeline::slot& emit_pipeline::acquire_slot_() {
+    rethrow_if_failed_();
+
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+        stats_.full_waits++;
+        backoff idle;
+        while (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+            idle.pause();
+        }
+    }
+    return slots_[tail % slots_.size()];
+}
+
+void emit_pipeline::publish_slot_() {
+    stats_.records++;
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void emit_pipeline::push(const dual_fullerene& G, const expansion_step& step) {
+    auto& s = acquire_slot_();
+    if (out_.get_format() == output_format::DELTA) {
+        s.graph.id = G.get_id();
+        s.graph.parent_id = G.get_parent_id();
+    }
+    else {
+        G.save_snapshot(s.graph);
+    }
+    s.step = step;
+    publish_slot_();
+}
+
+void emit_pipeline::push(dual_fullerene::snapshot& graph, const expansion_step& step) {
+    auto& s = acquire_slot_();
+    std::swap(s.graph, graph);
+    s.step = step;
+    publish_slot_();
+}
+
+void emit_pipeline::drain() {
+    backoff idle;
+    while (head_.load(std::memory_order_acquire) != tail_.load(std::memory_order_relaxed)) {
+        idle.pause();
+    }
+    rethrow_if_failed_();
+}
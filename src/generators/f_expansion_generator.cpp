@@ -1,11 +1,19 @@
-﻿#include <iostream>
-#include "expansions/f_expansion.h"
+﻿#include "expansions/f_expansion.h"
 #include "fullerene/construct.h"
 #include "generators/f_expansion_generator.h"
 
 constexpr size_t C30_SIZE = 30;
 constexpr size_t F_EXPANSION_SIZE_INCREMENT = 10;
 
+void f_expansion_generator::emit_(dual_fullerene& G, const expansion_step& step) {
+    if (written_) {
+        register_and_emit(G, step);
+    }
+    else {
+        register_only(G);
+    }
+}
+
 void f_expansion_generator::generate(std::size_t up_to) {
     if (up_to < C30_SIZE) {
         return;
@@ -13,18 +21,22 @@ void f_expansion_generator::generate(std::size_t up_to) {
 
     size_t current_size = C30_SIZE;
     auto C30_dual = create_c30_fullerene();
+    C30_dual.reserve(up_to / 2 + 2);
 
-    register_and_emit(C30_dual);
+    emit_(C30_dual, { step_type::SEED_C30 });
     current_size += F_EXPANSION_SIZE_INCREMENT;
 
     while (current_size <= up_to) {
-        auto expansion = f_expansion(C30_dual, C30_dual.get_nodes_5()[0]);
+        const auto pentagon = C30_dual.get_nodes_5()[0];
+        auto expansion = f_expansion(C30_dual, pentagon);
         if (!expansion.validate()) {
             throw std::logic_error("The F expansion can't be performed");
         }
         expansion.apply();
 
-        register_and_emit(C30_dual);
+        expansion_step step{ step_type::F };
+        step.start = { pentagon, 0 };
+        emit_(C30_dual, step);
         current_size += F_EXPANSION_SIZE_INCREMENT;
     }
 }
@@ -4,10 +4,19 @@
 #include <expansions/b_reduction.h>
 #include <expansions/l_expansion.h>
 #include <expansions/l_reduction.h>
+#include <expansions/reduction_catalogue.h>
 #include <fullerene/construct.h>
+#include <generators/id_registry.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -33,27 +42,293 @@ namespace {
         return r;
     }
 
-} 
+    // a worker hands out a subtree only while its own deque is nearly empty, otherwise it recurses inline
+    constexpr std::size_t SPAWN_QUEUE_LIMIT = 2;
+
+    // the size of a maximal matching of adjacent pentagons, a lower bound on the pentagons that have to move
+    // before the graph is IPR. Pentagons are vertices 0..11, so a bit mask tracks the matched ones.
+    int disjoint_adjacent_pentagon_pairs(const dual_fullerene& G)
+    {
+        std::uint16_t matched = 0;
+        int pairs = 0;
+        for (const auto p : G.get_nodes_5()) {
+            if (matched & (1u << p)) {
+                continue;
+            }
+            for (std::size_t i = 0; i < G.degree(p); ++i) {
+                const auto q = G.neighbor_at(p, i);
+                if (G.type(q) == node_type::NODE_5 && !(matched & (1u << q))) {
+                    matched |= static_cast<std::uint16_t>((1u << p) | (1u << q));
+                    ++pairs;
+                    break;
+                }
+            }
+        }
+        return pairs;
+    }
+
+    // C20 is expanded by L0 and L1 only
+    constexpr main_generator::search_bounds ROOT_BOUNDS{ 1, -1, 1 };
+
+    // an automatic split depth has at least this many graphs per slice, so the round robin evens out
+    // subtree sizes that differ by orders of magnitude
+    constexpr double SPLIT_GRAPHS_PER_SLICE = 64;
+    constexpr std::size_t AUTO_SPLIT_PROBES = 64;
+    constexpr int MAX_AUTO_SPLIT_DEPTH = 16;
+
+    int choose_split_depth(const search_estimate& estimate, const std::size_t mod)
+    {
+        const auto& per_depth = estimate.graphs_per_depth;
+        for (std::size_t depth = 0; depth < per_depth.size(); ++depth) {
+            if (per_depth[depth] >= SPLIT_GRAPHS_PER_SLICE * static_cast<double>(mod)) {
+                return static_cast<int>(depth);
+            }
+        }
+        return per_depth.empty() ? 0 : static_cast<int>(per_depth.size()) - 1;
+    }
+
+}
+
+main_generator::main_generator(fullerene_writer& out, const std::size_t threads, const search_split& split)
+    : base_generator(out), threads_(threads), split_(split)
+{
+    if (split_.mod == 0 || split_.res >= split_.mod || split_.depth < search_split::AUTO_DEPTH) {
+        throw std::invalid_argument("invalid search split");
+    }
+    if (split_.enabled()) {
+        split_scope_ = static_cast<std::uint32_t>(split_.res);
+    }
+}
+
+bool main_generator::enter_(dual_fullerene& G, const expansion_step& step, const int depth, const std::size_t worker)
+{
+    if (!split_.enabled()) {
+        emit_(G, step, depth, worker, true, fullerene_id::NO_SCOPE);
+        return true;
+    }
+
+    if (depth < split_depth_) {
+        emit_(G, step, depth, worker, split_.res == 0, fullerene_id::NO_SCOPE);
+        return true;
+    }
+
+    if (depth == split_depth_ && split_count_++ % split_.mod != split_.res) {
+        return false;
+    }
+
+    emit_(G, step, depth, worker, true, split_scope_);
+    return true;
+}
+
+void main_generator::emit_(dual_fullerene& G,
+    const expansion_step& step,
+    const int depth,
+    const std::size_t worker,
+    const bool written,
+    const std::uint32_t scope)
+{
+    if (order_ == nullptr) {
+        if (written) {
+            register_and_emit(G, step, scope);
+        }
+        else {
+            register_only(G, scope);
+        }
+        return;
+    }
+
+    // filtering and copying the graph happen here, in parallel; only the ids wait for the graph's turn
+    ordered_record record{ depth, written && is_written(G), scope, static_cast<std::uint32_t>(2 * G.total_nodes() - 4), step, {} };
+    if (record.written && writer().get_format() != output_format::DELTA) {
+        G.save_snapshot(record.graph);
+    }
+    order_->wait_for_room(segments_[worker], [&](ordered_output::segment* head, dfs_task& task) {
+        run_ordered_(head, task, worker);
+    });
+    order_->append(segments_[worker], std::move(record));
+}
+
+void main_generator::commit_(ordered_record& record)
+{
+    // records are committed in sequential dfs order, so the registry hands out the ids of a sequential search
+    const auto depth = static_cast<std::size_t>(record.depth);
+    ordered_ids_.resize(depth + 2);
+    ordered_ids_[depth + 1] = id_registry::register_id(record.atoms, record.scope);
+    if (!record.written) {
+        return;
+    }
+    record.graph.id = ordered_ids_[depth + 1];
+    record.graph.parent_id = ordered_ids_[depth];
+    emit_snapshot(record.graph, record.step);
+}
+
+void main_generator::run_ordered_(ordered_output::segment* segment, dfs_task& task, const std::size_t worker)
+{
+    // a worker that helps the head out runs its subtree nested in its own task, so it puts its segment back
+    auto* const outer = segments_[worker];
+    segments_[worker] = segment;
+    try {
+        dfs_(task.G, up_to_, task.bounds, task.depth, worker);
+        order_->close(segments_[worker]);
+    } catch (...) {
+        order_->abandon();
+        throw;
+    }
+    segments_[worker] = outer;
+}
+
+void main_generator::set_ordered_output(const std::size_t window)
+{
+    reorder_window_ = std::max<std::size_t>(window, 1);
+}
+
+void main_generator::enable_checkpoints(std::string file, const std::chrono::duration<double> interval)
+{
+    checkpoint_file_ = std::move(file);
+    checkpoint_interval_ = interval;
+}
+
+void main_generator::resume_from(search_checkpoint checkpoint)
+{
+    resumed_ = std::move(checkpoint);
+}
+
+void main_generator::maybe_checkpoint_()
+{
+    if (checkpoint_file_.empty()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_checkpoint_ < checkpoint_interval_) {
+        return;
+    }
+    last_checkpoint_ = now;
+
+    // the checkpoint may only claim what has reached the stream
+    drain_output();
+    auto& out = writer();
+    out.flush();
+
+    search_checkpoint checkpoint;
+    checkpoint.up_to = up_to_;
+    checkpoint.format = output_format_name(out.get_format());
+    checkpoint.split_res = split_.res;
+    checkpoint.split_mod = split_.mod;
+    checkpoint.split_depth = split_depth_;
+    checkpoint.split_count = split_count_;
+    checkpoint.output_bytes = out.bytes_written();
+    checkpoint.ids = id_registry::get_counters();
+    checkpoint.path = path_;
+    write_checkpoint(checkpoint_file_, checkpoint);
+}
 
 void main_generator::generate(std::size_t up_to)
 {
     if (up_to < 20) {
         return;
     }
+    if (threads_ > 1 && (!checkpoint_file_.empty() || resumed_)) {
+        throw std::invalid_argument("checkpoints need a sequential search, split the run instead of using threads");
+    }
+    if (counts_only() && (!checkpoint_file_.empty() || resumed_)) {
+        throw std::invalid_argument("counting runs keep their counts in memory and can't be checkpointed");
+    }
+
+    up_to_ = up_to;
+    last_checkpoint_ = std::chrono::steady_clock::now();
+    path_.clear();
+    resume_.clear();
 
     {
         auto G = create_c20_fullerene();
-        register_and_emit(G);
-        dfs_(G, up_to, 1, -1, 1);
+        // a fullerene with up_to atoms has up_to / 2 + 2 faces, so the dfs never grows the storage
+        G.reserve(up_to / 2 + 2);
+
+        // counts don't depend on the order, so counting runs never buffer. Delta records have to follow their
+        // parent's, so threaded delta runs are always ordered.
+        auto window = reorder_window_;
+        if (window == 0 && writer().get_format() == output_format::DELTA) {
+            window = DEFAULT_REORDER_WINDOW;
+        }
+        std::optional<ordered_output> order;
+        if (window > 0 && threads_ > 1 && !counts_only()) {
+            order.emplace(window, [this](ordered_record& record) { commit_(record); });
+            order_ = &*order;
+            segments_.assign(threads_, nullptr);
+            segments_[0] = order->root();
+            ordered_ids_.assign(1, G.get_parent_id());
+        }
+
+        if (resumed_) {
+            auto checkpoint = std::move(*resumed_);
+            resumed_.reset();
+            if (checkpoint.up_to != up_to || checkpoint.format != output_format_name(writer().get_format())
+                || checkpoint.split_res != split_.res || checkpoint.split_mod != split_.mod) {
+                throw std::invalid_argument("the checkpoint was taken of a different run");
+            }
+
+            split_depth_ = checkpoint.split_depth;
+            split_count_ = checkpoint.split_count;
+            id_registry::restore_counters(std::move(checkpoint.ids));
+            // C20 was written before the checkpoint
+            G.assign_id(checkpoint.path.front().id);
+            path_.push_back(checkpoint.path.front());
+            resume_ = std::move(checkpoint.path);
+        }
+        else {
+            split_count_ = 0;
+            split_depth_ = split_.depth;
+            if (split_.enabled() && split_.depth == search_split::AUTO_DEPTH) {
+                split_depth_ = choose_split_depth(estimate(up_to, AUTO_SPLIT_PROBES, DEFAULT_ESTIMATE_SEED, MAX_AUTO_SPLIT_DEPTH), split_.mod);
+            }
+
+            // with a split at depth 0 the whole tree is a single subtree, owned by slice 0
+            if (!enter_(G, { step_type::SEED_C20 }, 0, 0)) {
+                return;
+            }
+            path_.push_back({ 0, G.get_id() });
+            maybe_checkpoint_();
+        }
+
+        if (threads_ > 1) {
+            work_stealing_pool<spawned_task> pool(threads_);
+            pool_ = &pool;
+            dfs_task root{ G, ROOT_BOUNDS, 0 };
+            if (order_ != nullptr) {
+                pool.push(0, { std::nullopt, order_->fork(segments_[0], std::move(root)) });
+                order_->close(segments_[0]);
+            }
+            else {
+                pool.push(0, { std::move(root), nullptr });
+            }
+            pool.run([&](spawned_task& spawned, const std::size_t worker) {
+                if (spawned.segment == nullptr) {
+                    dfs_(spawned.task->G, up_to, spawned.task->bounds, spawned.task->depth, worker);
+                }
+                // a blocked worker may have run the subtree already
+                else if (auto task = order_->claim(spawned.segment)) {
+                    run_ordered_(spawned.segment.get(), *task, worker);
+                }
+            });
+            pool_ = nullptr;
+        }
+        else {
+            dfs_(G, up_to, ROOT_BOUNDS, 0, 0);
+        }
+
+        if (order_ != nullptr) {
+            reorder_stats_ = order_->get_stats();
+            order_ = nullptr;
+        }
     }
 
-    if (up_to < 28) {
+    if (up_to < 28 || split_.res != 0) {
         return;
     }
 
     {
         auto G = create_c28_fullerene();
-        register_and_emit(G);
+        register_and_emit(G, { step_type::SEED_C28 });
     }
 
 }
@@ -72,45 +347,196 @@ int main_generator::bound_by_vertex_count_b(const dual_fullerene& G, std::size_t
     return dif / 2 - 3;
 }
 
-void main_generator::dfs_(dual_fullerene& G,
+search_estimate main_generator::estimate(const std::size_t up_to,
+    const std::size_t probes,
+    const std::uint64_t seed,
+    const int max_depth)
+{
+    search_estimate result;
+    result.probes = probes;
+    if (up_to < 20 || probes == 0) {
+        return result;
+    }
+
+    // the raw engine output is fixed by the standard, unlike the distributions, so every slice of a split
+    // run picks the same children
+    std::mt19937_64 rng(seed);
+    const auto root = create_c20_fullerene();
+
+    for (std::size_t probe = 0; probe < probes; ++probe) {
+        auto G = root;
+        G.reserve(up_to / 2 + 2);
+        auto bounds = ROOT_BOUNDS;
+        double weight = 1;
+
+        for (int depth = 0;; ++depth) {
+            if (result.graphs_per_depth.size() <= static_cast<std::size_t>(depth)) {
+                result.graphs_per_depth.resize(depth + 1);
+            }
+            result.graphs_per_depth[depth] += weight;
+            const auto atoms = 2 * G.total_nodes() - 4;
+            if (result.graphs_per_size.size() <= atoms) {
+                result.graphs_per_size.resize(atoms + 1);
+            }
+            result.graphs_per_size[atoms] += weight;
+            if (depth == max_depth) {
+                break;
+            }
+
+            // reservoir sampling picks a child uniformly in a single pass
+            std::size_t children = 0;
+            std::optional<dual_fullerene> chosen;
+            search_bounds chosen_bounds{};
+            const auto start = std::chrono::steady_clock::now();
+            for_each_child_(G, up_to, bounds, [&](const expansion_step&, const search_bounds& child_bounds) {
+                if (rng() % ++children == 0) {
+                    chosen = G;
+                    chosen_bounds = child_bounds;
+                }
+            });
+            result.seconds += weight * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (children == 0) {
+                break;
+            }
+            weight *= static_cast<double>(children);
+            G = std::move(*chosen);
+            G.clear_journal();
+            bounds = chosen_bounds;
+        }
+    }
+
+    const auto scale = 1.0 / static_cast<double>(probes);
+    for (auto& count : result.graphs_per_depth) {
+        count *= scale;
+        result.graphs += count;
+    }
+    for (auto& count : result.graphs_per_size) {
+        count *= scale;
+    }
+    result.seconds *= scale;
+    return result;
+}
+
+void main_generator::descend_(dual_fullerene& G,
     std::size_t up_to,
-    int max_size_l,
-    int max_param_sum_b,
-    int min_reduction_size)
+    const search_bounds& bounds,
+    int depth,
+    std::size_t worker)
 {
-    if (max_size_l < 0) {
+    // the graphs down to the split depth are numbered in dfs order, so the thread that searches the top of
+    // the tree keeps them to itself
+    const bool counted_by_this_thread = split_.enabled() && depth < split_depth_;
+    // with a full reorder window new subtrees would only buffer more
+    if (pool_ == nullptr || counted_by_this_thread || bounds.max_size_l < 0 || G.total_nodes() >= up_to
+        || pool_->queued(worker) >= SPAWN_QUEUE_LIMIT || (order_ != nullptr && !order_->has_room())) {
+        dfs_(G, up_to, bounds, depth, worker);
         return;
     }
 
-    if (G.total_nodes() >= up_to) {
+    dfs_task task{ G, bounds, depth };
+    task.G.clear_journal();
+    task.G.reserve(up_to / 2 + 2);
+    if (order_ != nullptr) {
+        pool_->push(worker, { std::nullopt, order_->fork(segments_[worker], std::move(task)) });
         return;
     }
+    pool_->push(worker, { std::move(task), nullptr });
+}
 
-    std::vector<std::unique_ptr<base_expansion>> expansions;
-    expansions.reserve(512);
+void main_generator::dfs_(dual_fullerene& G,
+    std::size_t up_to,
+    const search_bounds& bounds,
+    int depth,
+    std::size_t worker)
+{
+    // a resumed search walks back down the checkpointed path; the children before it on the path were
+    // searched completely before the checkpoint and the one on the path was already written
+    const bool resuming = static_cast<std::size_t>(depth) + 1 < resume_.size();
+    const std::size_t resumed_ordinal = resuming ? resume_[depth + 1].ordinal : 0;
+    // only a sequential search has a single path to record
+    const bool tracked = pool_ == nullptr;
+    std::size_t ordinal = 0;
 
-    for (int s = 0; s <= max_size_l; s++) {
-        {
-            auto v = find_l_expansions(G, s);
-            expansions.reserve(expansions.size() + v.size());
-            for (auto& up : v) {
-                expansions.push_back(std::move(up));
+    for_each_child_(G, up_to, bounds, [&](const expansion_step& step, const search_bounds& child_bounds) {
+        const auto index = ordinal++;
+        if (resuming && index <= resumed_ordinal) {
+            if (index == resumed_ordinal) {
+                auto frame = resume_[depth + 1];
+                G.assign_id(frame.id);
+                path_.push_back(std::move(frame));
+                if (resume_.size() == static_cast<std::size_t>(depth) + 2) {
+                    resume_.clear();
+                }
+                descend_(G, up_to, child_bounds, depth + 1, worker);
+                path_.pop_back();
+                release_id(G);
             }
+            return;
         }
-    }
-    for (int s=0;s<=max_param_sum_b;s++)
-    {
-            for (int pre = 0; pre <= s; pre++) {
-                int post = s - pre;
-                auto v = find_b_expansions(G, pre, post);
-                expansions.reserve(expansions.size() + v.size());
-                for (auto& up : v) {
-                    expansions.push_back(std::move(up));
-                }
+
+        if (enter_(G, step, depth + 1, worker)) {
+            if (tracked) {
+                path_.push_back({ index, G.get_id() });
+                maybe_checkpoint_();
+            }
+            descend_(G, up_to, child_bounds, depth + 1, worker);
+            if (tracked) {
+                path_.pop_back();
             }
+            // with ordered output G never got its id, the reorder buffer assigns it
+            if (order_ == nullptr) {
+                release_id(G);
+            }
+        }
+    });
+}
+
+template<typename Visit>
+void main_generator::for_each_child_(dual_fullerene& G,
+    std::size_t up_to,
+    const search_bounds& bounds,
+    Visit&& visit)
+{
+    const int max_size_l = bounds.max_size_l;
+    const int max_param_sum_b = bounds.max_param_sum_b;
+    const int min_reduction_size = bounds.min_reduction_size;
+
+    if (max_size_l < 0) {
+        return;
+    }
+
+    if (G.total_nodes() >= up_to) {
+        return;
+    }
+
+    auto expansions = find_l_expansions_up_to(G, max_size_l);
+    auto bs = find_b_expansions_up_to(G, max_param_sum_b);
+    expansions.reserve(expansions.size() + bs.size());
+    for (auto& up : bs) {
+        expansions.push_back(std::move(up));
     }
 
+    // the reductions of the child currently applied, shared by the canonicity test and the bounds after it.
+    // Children only differ from G around their expansion, so each takes the reductions far from it from
+    // G's catalogue, which the children fill as they go.
+    reduction_catalogue parent_reductions(G);
+    reduction_catalogue reductions(G);
+    const int max_x0 = std::max({ max_size_l + 1, max_param_sum_b + 2, 2 });
 
+    // Every reduction joins two pentagons at most x0 edges apart, so a graph whose pentagons are k apart is at
+    // least 2 (k + 1) atoms larger than its parent. An expansion only moves the two pentagons at its ends and
+    // keeps every other pair of adjacent pentagons adjacent, so a child with m disjoint adjacent pairs needs at
+    // least ceil(m / 2) more expansions, of at least 4 atoms each. Children that can't fit that below up_to
+    // are cut before the canonicity test.
+    const auto k = static_cast<int>(min_pentagon_distance());
+    const auto hopeless = [&](const int x0) {
+        if (k <= 1 || (x0 >= k && G.has_pentagon_distance(k))) {
+            return false;
+        }
+        const auto expansions_needed = std::max(1, (disjoint_adjacent_pentagon_pairs(G) + 1) / 2);
+        return 2 * G.total_nodes() - 4 + static_cast<std::size_t>(4 * (expansions_needed - 1) + 2 * (k + 1)) > up_to;
+    };
 
     for (auto& up : expansions) {
         if (!up->validate()) {
@@ -118,19 +544,21 @@ void main_generator::dfs_(dual_fullerene& G,
         }
 
         if (auto* le = dynamic_cast<l_expansion*>(up.get())) {
-
-
-            const auto cand = le->candidate();
-            up->apply();;
+            const auto mark = G.checkpoint();
+            up->apply();
+            if (hopeless(le->candidate().length + 1)) {
+                G.rollback(mark);
+                continue;
+            }
+            reductions.reset(parent_reductions, mark, max_x0);
             auto red = std::make_unique<l_reduction>(matching_reduction_from_expansion(*le));
 
-            if (red->is_canonical(G, min_reduction_size, -1, -1)) {
-                register_and_emit(G);
+            if (red->is_canonical(reductions, min_reduction_size, -1)) {
                 int next_max_l_bound = bound_by_vertex_count_l(G, up_to);
                 int next_max_b_bound = bound_by_vertex_count_b(G, up_to);
                 int bound_by_size = red->x0() + 1;
                 if (red->x0() == 1) {
-                    if (has_L0_pair_pent_distance_gt4(G)) {
+                    if (has_L0_pair_pent_distance_gt4(reductions)) {
                         bound_by_size = 0;
                     }
                     else {
@@ -141,26 +569,30 @@ void main_generator::dfs_(dual_fullerene& G,
                 int next_max_l = std::min({ next_max_l_bound, bound_by_size, four_bound_for_smaller });
                 int next_max_b = std::min({ next_max_b_bound, bound_by_size, four_bound_for_smaller });
                 if (next_max_l >= 2 || next_max_b >= 2) {
-                    int temp = limit_by_reduction_distances(G, next_max_b);
+                    int temp = limit_by_reduction_distances(reductions, next_max_b);
                     next_max_l = std::min(next_max_l, temp);
                     next_max_b = std::min(next_max_b, temp);
                 }
-                dfs_(G, up_to, next_max_l, next_max_b, min_reduction_size);
-                G.reduce_id();
+                const auto& cand = le->candidate();
+                visit(expansion_step{ step_type::L, cand.start, cand.clockwise, cand.length, 0 },
+                    search_bounds{ next_max_l, next_max_b, min_reduction_size });
             }
 
-
-            red->apply(G, cand);
+            G.rollback(mark);
             continue;
         }
 
         if (auto* be = dynamic_cast<b_expansion*>(up.get())) {
-            const auto cand = be->candidate();
+            const auto mark = G.checkpoint();
             up->apply();
-     
+            if (hopeless(be->candidate().length_pre_bend + be->candidate().length_post_bend + 2)) {
+                G.rollback(mark);
+                continue;
+            }
+            reductions.reset(parent_reductions, mark, max_x0);
+
             auto red = std::make_unique<b_reduction>(matching_reduction_from_expansion(*be));
-            if (red->is_canonical(G, min_reduction_size, red->length_pre_bend, red->length_post_bend)) {
-                register_and_emit(G);
+            if (red->is_canonical(reductions, min_reduction_size, red->length_pre_bend)) {
                 int next_max_l_bound = bound_by_vertex_count_l(G, up_to);
                 int next_max_b_bound = bound_by_vertex_count_b(G, up_to);
                 int bound_by_size = red->x0() + 1;
@@ -168,17 +600,17 @@ void main_generator::dfs_(dual_fullerene& G,
                 int next_max_l = std::min({ next_max_l_bound, bound_by_size, four_bound_for_smaller });
                 int next_max_b = std::min({ next_max_b_bound, bound_by_size, four_bound_for_smaller });
                 if (next_max_l >= 2 || next_max_b >= 2) {
-                    int temp = limit_by_reduction_distances(G, next_max_b);
+                    int temp = limit_by_reduction_distances(reductions, next_max_b);
                     next_max_l = std::min(next_max_l, temp);
                     next_max_b = std::min(next_max_b, temp);
                 }
-                dfs_(G, up_to, next_max_l, next_max_b, min_reduction_size);
-                G.reduce_id();
+                const auto& cand = be->candidate();
+                visit(expansion_step{ step_type::B, cand.start, cand.clockwise, cand.length_pre_bend, cand.length_post_bend },
+                    search_bounds{ next_max_l, next_max_b, min_reduction_size });
             }
-            
-            red->apply(G, cand);
+
+            G.rollback(mark);
             continue;
         }
     }
-    
 }
@@ -0,0 +1,114 @@
+#include <generators/search_checkpoint.h>
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr std::string_view CHECKPOINT_HEADER = "fullerene_checkpoint";
+    constexpr int CHECKPOINT_VERSION = 1;
+    // stands in for the scope of the unscoped ids
+    constexpr std::string_view NO_SCOPE = "-";
+
+    template<typename T>
+    void read_entry(std::istream& is, const std::string_view key, T& value, const std::string& file) {
+        std::string name;
+        if (!(is >> name) || name != key || !(is >> value)) {
+            throw std::runtime_error("Malformed checkpoint " + file + ", expected " + std::string(key));
+        }
+    }
+}
+
+void write_checkpoint(const std::string& file, const search_checkpoint& checkpoint) {
+    const std::string temporary = file + ".tmp";
+    {
+        std::ofstream os(temporary, std::ios::trunc);
+        os << CHECKPOINT_HEADER << " " << CHECKPOINT_VERSION << "\n";
+        os << "up_to " << checkpoint.up_to << "\n";
+        os << "format " << checkpoint.format << "\n";
+        os << "split " << checkpoint.split_res << " " << checkpoint.split_mod << " " << checkpoint.split_depth << "\n";
+        os << "split_count " << checkpoint.split_count << "\n";
+        os << "output_bytes " << checkpoint.output_bytes << "\n";
+        os << "ids " << checkpoint.ids.size() << "\n";
+        for (const auto& [key, next] : checkpoint.ids) {
+            if (key.first == fullerene_id::NO_SCOPE) {
+                os << NO_SCOPE;
+            }
+            else {
+                os << key.first;
+            }
+            os << " " << key.second << " " << next << "\n";
+        }
+        os << "path " << checkpoint.path.size() << "\n";
+        for (const auto& frame : checkpoint.path) {
+            os << frame.ordinal << " " << frame.id.to_string() << "\n";
+        }
+
+        os.flush();
+        if (!os) {
+            throw std::runtime_error("Could not write checkpoint " + temporary);
+        }
+    }
+    std::filesystem::rename(temporary, file);
+}
+
+search_checkpoint read_checkpoint(const std::string& file) {
+    std::ifstream is(file);
+    if (!is) {
+        throw std::runtime_error("Could not open checkpoint " + file);
+    }
+
+    int version = 0;
+    read_entry(is, CHECKPOINT_HEADER, version, file);
+    if (version != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version) + " in " + file);
+    }
+
+    search_checkpoint checkpoint;
+    read_entry(is, "up_to", checkpoint.up_to, file);
+    read_entry(is, "format", checkpoint.format, file);
+    read_entry(is, "split", checkpoint.split_res, file);
+    if (!(is >> checkpoint.split_mod >> checkpoint.split_depth)) {
+        throw std::runtime_error("Malformed checkpoint " + file + ", expected split");
+    }
+    read_entry(is, "split_count", checkpoint.split_count, file);
+    read_entry(is, "output_bytes", checkpoint.output_bytes, file);
+
+    std::size_t entries = 0;
+    read_entry(is, "ids", entries, file);
+    for (std::size_t i = 0; i < entries; ++i) {
+        std::string scope;
+        std::uint32_t size;
+        std::uint64_t next;
+        if (!(is >> scope >> size >> next)) {
+            throw std::runtime_error("Truncated id counters in checkpoint " + file);
+        }
+        std::uint32_t scope_number = fullerene_id::NO_SCOPE;
+        if (scope != NO_SCOPE) {
+            const auto [end, error] = std::from_chars(scope.data(), scope.data() + scope.size(), scope_number);
+            if (error != std::errc() || end != scope.data() + scope.size()) {
+                throw std::runtime_error("Malformed id scope " + scope + " in checkpoint " + file);
+            }
+        }
+        checkpoint.ids[{ scope_number, size }] = next;
+    }
+
+    read_entry(is, "path", entries, file);
+    checkpoint.path.resize(entries);
+    for (auto& frame : checkpoint.path) {
+        std::string id;
+        if (!(is >> frame.ordinal >> id)) {
+            throw std::runtime_error("Truncated search path in checkpoint " + file);
+        }
+        if (!fullerene_id::parse(id, frame.id)) {
+            throw std::runtime_error("Malformed id " + id + " in checkpoint " + file);
+        }
+    }
+    if (checkpoint.path.empty()) {
+        throw std::runtime_error("Checkpoint " + file + " has an empty search path");
+    }
+
+    return checkpoint;
+}
@@ -14,33 +14,41 @@
 inline void validate_dual_fullerene(const dual_fullerene& f) {
     REQUIRE(f.get_nodes_5().size() == 12);
 
-    for (auto& u: f.get_nodes_5()) {
-        REQUIRE(u->degree() == 5);
+    for (auto u: f.get_nodes_5()) {
+        REQUIRE(f.degree(u) == 5);
 
-        for (auto& weak_v : u->neighbors()) {
-            auto v = weak_v.lock();
-            REQUIRE(v);
+        for (std::size_t i = 0; i < f.degree(u); ++i) {
+            auto v = f.neighbor_at(u, i);
+            REQUIRE(v < f.total_nodes());
 
             size_t count = 0;
-            for (auto& weak_v2 : u->neighbors())
-                if (weak_v2.lock() == v) count++;
+            for (std::size_t j = 0; j < f.degree(u); ++j)
+                if (f.neighbor_at(u, j) == v) count++;
 
             REQUIRE(count == 1);
+
+            const auto inv = f.inverse(f.get_edge(u, i));
+            REQUIRE(inv.from == v);
+            REQUIRE(f.to(inv) == u);
         }
     }
 
-    for (auto& u: f.get_nodes_6()) {
-        REQUIRE(u->degree() == 6);
+    for (auto u: f.get_nodes_6()) {
+        REQUIRE(f.degree(u) == 6);
 
-        for (auto& weak_v : u->neighbors()) {
-            auto v = weak_v.lock();
-            REQUIRE(v);
+        for (std::size_t i = 0; i < f.degree(u); ++i) {
+            auto v = f.neighbor_at(u, i);
+            REQUIRE(v < f.total_nodes());
 
             size_t count = 0;
-            for (auto& weak_v2 : u->neighbors())
-                if (weak_v2.lock() == v) count++;
+            for (std::size_t j = 0; j < f.degree(u); ++j)
+                if (f.neighbor_at(u, j) == v) count++;
 
             REQUIRE(count == 1);
+
+            const auto inv = f.inverse(f.get_edge(u, i));
+            REQUIRE(inv.from == v);
+            REQUIRE(f.to(inv) == u);
         }
     }
 }
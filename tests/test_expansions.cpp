@@ -78,9 +78,9 @@ TEST_CASE("No dangling neighbors after multiple F expansions", "[f_expansion]")
         exp.apply();
     }
 
-    d.for_each_node([&](const std::shared_ptr<base_node>& u) {
-        for (auto& w : u->neighbors()) {
-            REQUIRE(w.lock());
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            REQUIRE(d.neighbor_at(u, i) < d.total_nodes());
         }
     });
 }
@@ -197,11 +197,11 @@ TEST_CASE("L-expansion inverse reduction exists and is canonical", "[L_reduction
         for (const auto& r : reductions) {
             if (r.size != red_size) continue;
             if (r.use_next != cand.clockwise) continue;
-            if (r.first_edge.from->id() != cand.start.from->id()) continue;
-            if (r.second_edge.from->id() != static_cast<unsigned>(cand.parallel_path[red_size + 1])) continue;
+            if (r.first_edge.from != cand.start.from) continue;
+            if (r.second_edge.from != static_cast<unsigned>(cand.parallel_path[red_size + 1])) continue;
 
             match_found = true;
-            REQUIRE(r.is_canonical(G, red_size, -1, -1));
+            REQUIRE(r.is_canonical(G, red_size, -1));
             break;
         }
 
@@ -209,6 +209,41 @@ TEST_CASE("L-expansion inverse reduction exists and is canonical", "[L_reduction
     }
 }
 
+TEST_CASE("L candidates of all lengths come out of one walk as they do length by length", "[l_expansion]") {
+    constexpr int max_length = 5;
+
+    for (const auto& G : { create_c20_fullerene(), create_c28_fullerene(), create_c30_fullerene() }) {
+        const auto by_length = find_l_candidates_up_to(G, max_length);
+        REQUIRE(by_length.size() == max_length + 1);
+
+        for (int length = 0; length <= max_length; ++length) {
+            // the candidates as the rails of each length on their own define them
+            std::vector<l_expansion_candidate> expected;
+            for (const auto node : G.get_nodes_5()) {
+                for (std::uint32_t i = 0; i < G.degree(node); ++i) {
+                    for (const bool clockwise : { true, false }) {
+                        std::vector<int> P, Q;
+                        build_l_rails(G, { node, i }, clockwise, length, P, Q);
+                        if (G.degree(static_cast<unsigned>(Q.back())) == 5 && patch_nodes_unique(P, Q)) {
+                            expected.push_back({ { { node, i }, clockwise, P, Q }, length });
+                        }
+                    }
+                }
+            }
+
+            const auto& found = by_length[length];
+            REQUIRE(found.size() == expected.size());
+            for (std::size_t k = 0; k < found.size(); ++k) {
+                REQUIRE(found[k].start == expected[k].start);
+                REQUIRE(found[k].clockwise == expected[k].clockwise);
+                REQUIRE(found[k].path == expected[k].path);
+                REQUIRE(found[k].parallel_path == expected[k].parallel_path);
+                REQUIRE(found[k].length == length);
+            }
+        }
+    }
+}
+
 // test b_expansion
 TEST_CASE("C20 B(0, 0) candidate count is correct", "[b_expansion]") {
     dual_fullerene G = create_c20_fullerene();
@@ -253,3 +288,29 @@ TEST_CASE("C30 B(i, i) expansions preserve dual fullerene validity", "[l_expansi
     }
 }
 
+
+TEST_CASE("B candidates of all splits come out of one sweep as they do split by split", "[b_expansion]") {
+    constexpr int max_param_sum = 4;
+
+    for (const auto& G : { create_c20_fullerene(), create_c28_fullerene(), create_c30_fullerene() }) {
+        const auto by_split = find_b_candidates_up_to(G, max_param_sum);
+        REQUIRE(by_split.size() == max_param_sum + 1);
+
+        for (int pre = 0; pre <= max_param_sum; ++pre) {
+            REQUIRE(by_split[pre].size() == static_cast<std::size_t>(max_param_sum - pre + 1));
+            for (int post = 0; pre + post <= max_param_sum; ++post) {
+                const auto expected = find_b_candidates(G, pre, post);
+                const auto& found = by_split[pre][post];
+                REQUIRE(found.size() == expected.size());
+                for (std::size_t k = 0; k < found.size(); ++k) {
+                    REQUIRE(found[k].start == expected[k].start);
+                    REQUIRE(found[k].clockwise == expected[k].clockwise);
+                    REQUIRE(found[k].path == expected[k].path);
+                    REQUIRE(found[k].parallel_path == expected[k].parallel_path);
+                    REQUIRE(found[k].length_pre_bend == pre);
+                    REQUIRE(found[k].length_post_bend == post);
+                }
+            }
+        }
+    }
+}
@@ -2,6 +2,10 @@
 #include <catch2/internal/catch_preprocessor_internal_stringify.hpp>
 #include <catch2/internal/catch_test_macro_impl.hpp>
 #include <catch2/internal/catch_test_registry.hpp>
+#include <fullerene/fullerene_writer.h>
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
 
 // construct tests
 TEST_CASE("Base dual fullerenes are structurally valid", "[dual_fullerene]") {
@@ -14,128 +18,179 @@ TEST_CASE("Base dual fullerenes are structurally valid", "[dual_fullerene]") {
     validate_dual_fullerene(d3);
 }
 
-// base_node tests
-TEST_CASE("base_node basic functionality", "[base_node]") {
-    const auto n5 = node_5::create(1);
-    const auto n6 = node_6::create(2);
+// vertex storage tests
+TEST_CASE("dual_fullerene vertex basic functionality", "[dual_fullerene]") {
+    auto d = create_c20_fullerene();
+    const auto empty = static_cast<unsigned int>(d.add_vertex(node_type::NODE_6));
+    const auto sized = static_cast<unsigned int>(d.add_sized_vertex(node_type::NODE_6));
 
-    REQUIRE(n5->expected_degree() == 5);
-    REQUIRE(n6->expected_degree() == 6);
+    REQUIRE(d.type(0) == node_type::NODE_5);
+    REQUIRE(d.type(empty) == node_type::NODE_6);
 
-    REQUIRE(n5->degree() == 0);
-    REQUIRE(n6->degree() == 0);
+    REQUIRE(d.degree(empty) == 0);
+    REQUIRE(d.degree(sized) == 6);
 }
 
-TEST_CASE("Neighbors can be added and are reciprocal", "[base_node]") {
-    const auto a = node_5::create(1);
-    const auto b = node_6::create(2);
+TEST_CASE("Neighbors can be added and are reciprocal", "[dual_fullerene]") {
+    auto d = create_c20_fullerene();
+    const auto a = d.add_vertex(node_type::NODE_6);
+    const auto b = d.add_vertex(node_type::NODE_6);
 
-    a->add_neighbor(b);
-    b->add_neighbor(a);
+    d.add_neighbor(a, b);
+    d.add_neighbor(b, a);
 
-    REQUIRE(a->degree() == 1);
-    REQUIRE(b->degree() == 1);
-    REQUIRE(a->is_neighbor_of(b));
-    REQUIRE(b->is_neighbor_of(a));
+    REQUIRE(d.degree(a) == 1);
+    REQUIRE(d.degree(b) == 1);
+    REQUIRE(d.is_neighbor_of(a, b));
+    REQUIRE(d.is_neighbor_of(b, a));
 }
 
-// directed_edge tests
-TEST_CASE("directed_edge inverse is involutive", "[directed_edge]") {
-    auto a = node_5::create(0);
-    auto b = node_6::create(1);
-
-    a->add_neighbor(b);
-    b->add_neighbor(a);
+TEST_CASE("Copies of a dual fullerene do not share storage", "[dual_fullerene]") {
+    const auto d = create_c20_fullerene();
+    auto copy = d;
 
-    auto e = a->get_edge(0);
+    copy.replace_neighbor(0, 1, 11);
 
-    REQUIRE(e.inverse().inverse().from == e.from);
-    REQUIRE(e.inverse().inverse().to() == e.to());
+    REQUIRE(d.neighbor_at(0, 0) == 1);
+    REQUIRE(copy.neighbor_at(0, 0) == 11);
 }
 
-TEST_CASE("directed_edge next/prev around are inverses", "[directed_edge]") {
-    auto u = node_5::create_sized(0);
-    std::vector<std::shared_ptr<node_5>> nbrs(5);
+TEST_CASE("Vertex ids index storage directly through vertex churn", "[dual_fullerene]") {
+    auto d = create_c28_fullerene();
+    const auto n = d.total_nodes();
 
-    for (int i = 0; i < 5; ++i) {
-        nbrs[i] = node_5::create(i + 1);
-        u->set_neighbor_at(i, nbrs[i]);
-        nbrs[i]->add_neighbor(u);
+    const auto h = d.add_vertex(node_type::NODE_6);
+    REQUIRE(static_cast<std::size_t>(h) == n);
+    REQUIRE(d.get_nodes_6().back() == static_cast<unsigned int>(h));
+
+    d.move_neighborhood(12, h);
+    REQUIRE(d.degree(h) == 6);
+    REQUIRE(d.degree(12) == 0);
+    for (std::size_t i = 0; i < d.degree(h); ++i) {
+        REQUIRE(d.is_neighbor_of(d.neighbor_at(h, i), h));
     }
 
-    auto e = u->get_edge(2);
+    d.move_neighborhood(h, 12);
+    d.pop_last_node6();
+    REQUIRE(d.total_nodes() == n);
 
-    for (int k = 0; k < 5; ++k) {
-        REQUIRE(e.next_around(k).prev_around(k).to() == e.to());
-        REQUIRE(e.prev_around(k).next_around(k).to() == e.to());
+    for (std::size_t k = 0; k < d.get_nodes_6().size(); ++k) {
+        REQUIRE(d.get_nodes_6()[k] == 12 + k);
     }
+    validate_dual_fullerene(d);
 }
 
-TEST_CASE("directed_edge full rotation returns to original edge", "[directed_edge]") {
-    auto u = node_5::create_sized(0);
-    std::vector<std::shared_ptr<node_5>> nbrs(5);
-
-    for (int i = 0; i < 5; ++i) {
-        nbrs[i] = node_5::create(i + 1);
-        u->set_neighbor_at(i, nbrs[i]);
-        nbrs[i]->add_neighbor(u);
-    }
+TEST_CASE("Inverse slots follow insertions and removals", "[dual_fullerene]") {
+    auto d = create_c20_fullerene();
+    const auto h = d.add_vertex(node_type::NODE_6);
+
+    // splice h into the 0 -> 1 edge; slots after the insertion point shift in both rows
+    d.add_neighbor_after(0, 1, h);
+    d.add_neighbor_before(1, 0, h);
+    d.add_neighbor(h, 0);
+    d.add_neighbor(h, 1);
+
+    const auto e = d.get_edge_to(0, static_cast<unsigned int>(h));
+    REQUIRE(d.inverse(e) == d.get_edge_to(static_cast<unsigned int>(h), 0));
+    REQUIRE(d.inverse(d.inverse(e)) == e);
+
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            const auto inv = d.inverse(d.get_edge(u, i));
+            REQUIRE(inv == d.get_edge_to(d.neighbor_at(u, i), u));
+        }
+    });
 
-    auto e = u->get_edge(0);
-    auto cur = e;
+    d.remove_neighbor(0, h);
+    d.remove_neighbor(1, h);
+    d.clear_neighbors(h);
+    d.pop_last_node6();
+    validate_dual_fullerene(d);
+}
 
-    for (int i = 0; i < 5; ++i) {
-        cur = cur.next_around(1);
+// directed_edge tests
+TEST_CASE("Pentagon distances of the base dual fullerenes", "[dual_fullerene]") {
+    for (const auto& G : { create_c20_fullerene(), create_c28_fullerene(), create_c30_fullerene() }) {
+        REQUIRE(G.has_pentagon_distance(0));
+        REQUIRE(G.has_pentagon_distance(1));
+        REQUIRE_FALSE(G.has_pentagon_distance(2));
+        REQUIRE_FALSE(G.has_pentagon_distance(3));
+        REQUIRE(G.has_pentagon_distance(2) == G.is_ipr());
     }
+}
 
-    REQUIRE(cur.to() == e.to());
+TEST_CASE("directed_edge is a trivially copyable (vertex, slot) pair", "[directed_edge]") {
+    STATIC_REQUIRE(std::is_trivially_copyable_v<directed_edge>);
+    STATIC_REQUIRE(sizeof(directed_edge) == 2 * sizeof(std::uint32_t));
 }
 
-TEST_CASE("directed_edge basic navigation", "[directed_edge]") {
-    auto a = node_5::create(1);
-    auto b = node_6::create(2);
+TEST_CASE("directed_edge inverse is involutive", "[directed_edge]") {
+    const auto d = create_c20_fullerene();
 
-    a->add_neighbor(b);
-    b->add_neighbor(a);
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            const auto e = d.get_edge(u, i);
 
-    const auto e = a->get_edge(0);
+            REQUIRE(d.inverse(d.inverse(e)) == e);
+        }
+    });
+}
 
-    REQUIRE(e.to() == b);
+TEST_CASE("directed_edge next/prev around are inverses", "[directed_edge]") {
+    const auto d = create_c20_fullerene();
+    const auto e = d.get_edge(0, 2);
 
-    const auto inv = e.inverse();
-    REQUIRE(inv.to() == a);
+    for (int k = 0; k < 5; ++k) {
+        REQUIRE(d.to(d.prev_around(d.next_around(e, k), k)) == d.to(e));
+        REQUIRE(d.to(d.next_around(d.prev_around(e, k), k)) == d.to(e));
+    }
 }
 
-TEST_CASE("directed_edge complex navigation", "[directed_edge]") {
-    auto u = node_5::create_sized(1);
-    auto u_neighbors = std::vector<std::shared_ptr<node_5>>(5);
-
-    for (int i = 0; i < u_neighbors.size(); i++) {
-        u_neighbors[i] = node_5::create(i);
+TEST_CASE("directed_edge full rotation returns to original edge", "[directed_edge]") {
+    const auto d = create_c20_fullerene();
+    const auto e = d.get_edge(0, 0);
+    auto cur = e;
 
-        u->set_neighbor_at(i, u_neighbors[i]);
-        u_neighbors[i]->add_neighbor(u);
+    for (int i = 0; i < 5; ++i) {
+        cur = d.next_around(cur, 1);
     }
 
-    for (int i = 0; i < u_neighbors.size(); i++) {
-        u_neighbors[i]->add_neighbor(u_neighbors[(i + 1) % u_neighbors.size()]);
-        u_neighbors[i]->add_neighbor(u_neighbors[(i - 1 + u_neighbors.size()) % u_neighbors.size()]);
-    }
+    REQUIRE(cur == e);
+}
+
+TEST_CASE("directed_edge basic navigation", "[directed_edge]") {
+    auto d = create_c20_fullerene();
+    const auto a = d.add_vertex(node_type::NODE_6);
+    const auto b = d.add_vertex(node_type::NODE_6);
+
+    d.add_neighbor(a, b);
+    d.add_neighbor(b, a);
 
-    auto e = u->get_edge(0);
+    const auto e = d.get_edge(a, 0);
 
-    REQUIRE(e.to() == u_neighbors[0]);
-    REQUIRE(e.inverse().to() == u);
-    REQUIRE(e.left_turn(1).to() == u_neighbors[1]);
-    REQUIRE(e.right_turn(1).to() == u_neighbors[4]);
-    REQUIRE(e.left_turn(1).left_turn(1).to() == u);
-    REQUIRE(e.right_turn(1).right_turn(1).to() == u);
-    REQUIRE(e.prev_around(1).to() == u_neighbors[4]);
-    REQUIRE(e.next_around(1).to() == u_neighbors[1]);
+    REQUIRE(d.to(e) == static_cast<unsigned int>(b));
 
-    for (int i = 0; i < u_neighbors.size(); i++) {
-        REQUIRE(e.next_around(i).prev_around(i).to() == u_neighbors[0]);
-        REQUIRE(e.prev_around(i).next_around(i).to() == u_neighbors[0]);
+    const auto inv = d.inverse(e);
+    REQUIRE(d.to(inv) == static_cast<unsigned int>(a));
+}
+
+TEST_CASE("directed_edge complex navigation", "[directed_edge]") {
+    // vertex 0 of C20 is surrounded by 1, 2, 3, 4, 5 and vertex 1 by 0, 5, 6, 7, 2
+    const auto d = create_c20_fullerene();
+    const auto e = d.get_edge(0, 0);
+
+    REQUIRE(d.to(e) == 1);
+    REQUIRE(d.to(d.inverse(e)) == 0);
+    REQUIRE(d.to(d.left_turn(e, 1)) == 5);
+    REQUIRE(d.to(d.right_turn(e, 1)) == 2);
+    REQUIRE(d.to(d.left_turn(d.left_turn(e, 1), 1)) == 0);
+    REQUIRE(d.to(d.right_turn(d.right_turn(e, 1), 1)) == 0);
+    REQUIRE(d.to(d.prev_around(e, 1)) == 5);
+    REQUIRE(d.to(d.next_around(e, 1)) == 2);
+
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(d.to(d.prev_around(d.next_around(e, i), i)) == 1);
+        REQUIRE(d.to(d.next_around(d.prev_around(e, i), i)) == 1);
     }
 }
 
@@ -143,15 +198,15 @@ TEST_CASE("directed_edge complex navigation", "[directed_edge]") {
 TEST_CASE("dual_fullerene edges are bidirectional with matching indices", "[dual_fullerene]") {
     const auto d = create_c30_fullerene();
 
-    d.for_each_node([&](const std::shared_ptr<base_node>& u) {
-        for (std::size_t i = 0; i < u->degree(); ++i) {
-            auto e = u->get_edge(i);
-            auto v = e.to();
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            auto e = d.get_edge(u, i);
+            auto v = d.to(e);
 
-            REQUIRE(v->is_neighbor_of(u));
+            REQUIRE(d.is_neighbor_of(v, u));
 
-            auto inv = e.inverse();
-            REQUIRE(inv.to() == u);
+            auto inv = d.inverse(e);
+            REQUIRE(d.to(inv) == u);
         }
     });
 }
@@ -159,26 +214,26 @@ TEST_CASE("dual_fullerene edges are bidirectional with matching indices", "[dual
 TEST_CASE("edge_data is per-directed-edge and survives traversal", "[dual_fullerene]") {
     auto d = create_c20_fullerene();
 
-    d.for_each_node([&](const std::shared_ptr<base_node>& u) {
-        for (std::size_t i = 0; i < u->degree(); ++i) {
-            auto e = u->get_edge(i);
-            e.data().marked = true;
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            auto e = d.get_edge(u, i);
+            d.mark(e);
         }
     });
 
-    d.for_each_node([&](const std::shared_ptr<base_node>& u) {
-        for (std::size_t i = 0; i < u->degree(); ++i) {
-            auto e = u->get_edge(i);
-            REQUIRE(e.data().marked);
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            auto e = d.get_edge(u, i);
+            REQUIRE(d.is_marked(e));
         }
     });
 
     d.clear_all_edge_data();
 
-    d.for_each_node([&](const std::shared_ptr<base_node>& u) {
-        for (std::size_t i = 0; i < u->degree(); ++i) {
-            auto e = u->get_edge(i);
-            REQUIRE_FALSE(e.data().marked);
+    d.for_each_node([&](const unsigned int u) {
+        for (std::size_t i = 0; i < d.degree(u); ++i) {
+            auto e = d.get_edge(u, i);
+            REQUIRE_FALSE(d.is_marked(e));
         }
     });
 }
@@ -197,3 +252,169 @@ TEST_CASE("Fullerenes generated from base dual fullerenes are structurally valid
     validate_fullerene(f2, d2);
     validate_fullerene(f3, d3);
 }
+
+TEST_CASE("Repeated primal conversions do not see stale edge marks", "[fullerene]") {
+    auto d = create_c28_fullerene();
+    d.mark(d.get_edge(0, 0));
+
+    const auto f1 = d.to_primal();
+    const auto f2 = d.to_primal();
+
+    validate_fullerene(f1, d);
+    REQUIRE(f1.get_adjacency() == f2.get_adjacency());
+    REQUIRE(f1.get_outer_face_nodes() == f2.get_outer_face_nodes());
+}
+
+TEST_CASE("to_primal_into refills a reused fullerene in place", "[fullerene]") {
+    const auto d20 = create_c20_fullerene();
+    const auto d30 = create_c30_fullerene();
+
+    fullerene buffer;
+    d30.to_primal_into(buffer);
+    const auto* storage = buffer.get_adjacency_view().data();
+
+    d20.to_primal_into(buffer);
+    const auto expected = d20.to_primal();
+
+    REQUIRE(buffer.get_adjacency_view().data() == storage);
+    REQUIRE(buffer.get_size() == expected.get_size());
+    REQUIRE(buffer.get_adjacency() == expected.get_adjacency());
+    REQUIRE(buffer.get_outer_face_nodes() == expected.get_outer_face_nodes());
+    REQUIRE(buffer.write_all() == expected.write_all());
+    validate_fullerene(buffer, d20);
+}
+
+TEST_CASE("fullerene_writer output matches the stream operator", "[fullerene]") {
+    const auto f1 = create_c20_fullerene().to_primal();
+    const auto f2 = create_c28_fullerene().to_primal();
+    const auto f3 = create_c30_fullerene().to_primal();
+
+    std::ostringstream expected;
+    expected << f1 << f2 << f3 << f1;
+
+    // a block smaller than one record forces a flush and a buffer resize
+    for (const std::size_t block_size : { std::size_t{ 16 }, std::size_t{ 700 }, fullerene_writer::DEFAULT_BLOCK_SIZE }) {
+        std::ostringstream actual;
+        {
+            fullerene_writer out(actual, block_size);
+            out.write(f1);
+            out.write(f2);
+            out.write(f3);
+            out.write(f1);
+        }
+        REQUIRE(actual.str() == expected.str());
+    }
+}
+
+TEST_CASE("Fullerene ids read back from their text", "[fullerene_id]") {
+    const fullerene_id base{};
+    const fullerene_id plain{ 60, fullerene_id::NO_SCOPE, 1811 };
+    const fullerene_id scoped{ 60, 2, 17 };
+
+    REQUIRE(base.to_string() == "BASE");
+    REQUIRE(plain.to_string() == "60:1811");
+    REQUIRE(scoped.to_string() == "60:2/17");
+
+    for (const auto& id : { base, plain, scoped }) {
+        fullerene_id parsed{ 1, 1, 1 };
+        REQUIRE(fullerene_id::parse(id.to_string(), parsed));
+        REQUIRE(parsed == id);
+    }
+
+    fullerene_id unused;
+    for (const auto* text : { "", "60", "60:", ":5", "60:x", "60:1/", "0:4", "60:1/2/3" }) {
+        REQUIRE_FALSE(fullerene_id::parse(text, unused));
+    }
+}
+
+TEST_CASE("Binary records carry the header, ids and adjacency", "[fullerene]") {
+    auto d = create_c28_fullerene();
+    d.register_id();
+    const auto f = d.to_primal();
+
+    std::ostringstream os;
+    {
+        fullerene_writer out(os, output_format::BINARY);
+        out.write(f);
+    }
+
+    const std::string bytes = os.str();
+    const std::string header = ">>fullerene_binary<<";
+    REQUIRE(bytes.starts_with(header));
+
+    std::size_t at = header.size();
+    auto next = [&]() { return static_cast<unsigned int>(static_cast<unsigned char>(bytes.at(at++))); };
+
+    const auto size = next() | (next() << 8);
+    REQUIRE(size == f.get_size());
+    REQUIRE(next() == (f.is_ipr() ? 1u : 0u));
+
+    const auto id_length = next();
+    REQUIRE(bytes.substr(at, id_length) == f.get_id().to_string());
+    at += id_length;
+    const auto parent_length = next();
+    REQUIRE(bytes.substr(at, parent_length) == f.get_parent_id().to_string());
+    at += parent_length;
+
+    for (const auto v : f.get_outer_face_nodes()) {
+        REQUIRE(next() == v);
+    }
+    for (const auto& adj : f.get_adjacency()) {
+        for (const auto v : adj) {
+            REQUIRE(next() == v);
+        }
+    }
+    REQUIRE(at == bytes.size());
+}
+
+TEST_CASE("planar_code output is a consistent embedding", "[fullerene]") {
+    for (const auto& d : { create_c20_fullerene(), create_c28_fullerene(), create_c30_fullerene() }) {
+        const auto f = d.to_primal();
+
+        std::ostringstream os;
+        {
+            fullerene_writer out(os, output_format::PLANAR_CODE);
+            out.write(f);
+        }
+
+        const std::string bytes = os.str();
+        const std::string header = ">>planar_code le<<";
+        REQUIRE(bytes.starts_with(header));
+
+        std::size_t at = header.size();
+        auto next = [&]() { return static_cast<unsigned int>(static_cast<unsigned char>(bytes.at(at++))); };
+
+        const auto n = next();
+        REQUIRE(n == f.get_size());
+
+        std::vector<std::array<unsigned int, 3>> rotation(n);
+        for (auto& row : rotation) {
+            for (auto& u : row) {
+                u = next() - 1;
+            }
+            REQUIRE(next() == 0);
+        }
+        REQUIRE(at == bytes.size());
+
+        // trace the faces of the embedding: a consistent rotation system of a fullerene has n / 2 + 2 faces
+        std::vector<std::array<bool, 3>> used(n, { false, false, false });
+        std::size_t faces = 0;
+        for (unsigned int v = 0; v < n; v++) {
+            for (std::size_t k = 0; k < 3; k++) {
+                if (used[v][k]) continue;
+
+                unsigned int a = v;
+                std::size_t slot = k;
+                while (!used[a][slot]) {
+                    used[a][slot] = true;
+                    const auto b = rotation[a][slot];
+                    const auto back = static_cast<std::size_t>(std::ranges::find(rotation[b], a) - rotation[b].begin());
+                    a = b;
+                    slot = (back + 1) % 3;
+                }
+                faces++;
+            }
+        }
+        REQUIRE(faces == n / 2 + 2);
+    }
+}
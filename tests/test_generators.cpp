@@ -0,0 +1,547 @@
+#include <validation.h>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fullerene/fullerene_writer.h>
+#include <generators/delta_decoder.h>
+#include <generators/emit_pipeline.h>
+#include <generators/f_expansion_generator.h>
+#include <generators/id_registry.h>
+#include <generators/main_generator.h>
+#include <generators/search_checkpoint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <streambuf>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// the records of a text stream without their first line, which holds the run-dependent ids
+static std::vector<std::string> text_record_bodies(const std::string& text)
+{
+    std::vector<std::string> bodies;
+    std::istringstream is(text);
+    std::string line;
+
+    while (std::getline(is, line)) {
+        const auto size = std::stoul(line.substr(0, line.find(' ')));
+        std::string body;
+        for (std::size_t i = 0; i < size + 1 && std::getline(is, line); ++i) {
+            body += line + "\n";
+        }
+        bodies.push_back(body);
+    }
+
+    return bodies;
+}
+
+// the ids of the records of a text stream, in stream order
+static std::vector<std::string> text_record_ids(const std::string& text)
+{
+    std::vector<std::string> ids;
+    std::istringstream is(text);
+    std::string line;
+
+    while (std::getline(is, line)) {
+        std::istringstream header(line);
+        std::size_t size;
+        std::string id;
+        header >> size >> id;
+        ids.push_back(id);
+        for (std::size_t i = 0; i < size + 1 && std::getline(is, line); ++i) {
+        }
+    }
+
+    return ids;
+}
+
+// each record's body paired with its parent's body, or with the parent's id when the stream doesn't hold it
+static std::vector<std::pair<std::string, std::string>> text_record_links(const std::string& text)
+{
+    const auto bodies = text_record_bodies(text);
+    const auto ids = text_record_ids(text);
+    std::map<std::string, std::string> body_of;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        body_of[ids[i]] = bodies[i];
+    }
+
+    std::vector<std::pair<std::string, std::string>> links;
+    std::istringstream is(text);
+    std::string line;
+    for (std::size_t i = 0; std::getline(is, line); ++i) {
+        std::istringstream header(line);
+        std::size_t size;
+        std::string id;
+        std::string parent;
+        header >> size >> id >> parent;
+        const auto found = body_of.find(parent);
+        links.emplace_back(bodies[i], found != body_of.end() ? found->second : parent);
+        for (std::size_t k = 0; k < size + 1 && std::getline(is, line); ++k) {
+        }
+    }
+
+    return links;
+}
+
+// decodes a delta stream record by record and writes the graphs as text
+static std::string decode_delta_stream(const std::string& delta)
+{
+    std::istringstream is(delta);
+    REQUIRE(read_delta_header(is));
+
+    delta_decoder decoder;
+    delta_record record;
+    std::string decoded;
+
+    while (read_delta_record(is, record)) {
+        const auto& G = decoder.decode(record);
+        validate_dual_fullerene(G);
+        REQUIRE(G.get_id() == record.id);
+        REQUIRE(G.get_parent_id() == record.parent_id);
+
+        decoded += G.to_primal().write_all();
+    }
+
+    return decoded;
+}
+
+TEST_CASE("Delta streams decode to the graphs of a full run", "[delta]") {
+    constexpr std::size_t up_to = 50;
+
+    std::ostringstream text;
+    {
+        fullerene_writer out(text);
+        main_generator(out).generate(up_to);
+    }
+
+    std::ostringstream delta;
+    {
+        fullerene_writer out(delta, output_format::DELTA);
+        main_generator(out).generate(up_to);
+    }
+
+    REQUIRE(text_record_bodies(decode_delta_stream(delta.str())) == text_record_bodies(text.str()));
+}
+
+TEST_CASE("Threaded delta streams decode without asking for ordered output", "[delta]") {
+    constexpr std::size_t up_to = 50;
+
+    std::ostringstream text;
+    {
+        fullerene_writer out(text);
+        main_generator(out).generate(up_to);
+    }
+
+    std::ostringstream delta;
+    {
+        fullerene_writer out(delta, output_format::DELTA);
+        main_generator(out, 4).generate(up_to);
+    }
+
+    REQUIRE(text_record_bodies(decode_delta_stream(delta.str())) == text_record_bodies(text.str()));
+}
+
+TEST_CASE("Delta records with an unknown parent are rejected", "[delta]") {
+    std::istringstream is(">>fullerene_delta<<\n20:0 BASE C20\n24:0 22:7 L 0 0 1 0\n");
+    REQUIRE(read_delta_header(is));
+
+    delta_decoder decoder;
+    delta_record record;
+
+    REQUIRE(read_delta_record(is, record));
+    REQUIRE_NOTHROW(decoder.decode(record));
+    REQUIRE(read_delta_record(is, record));
+    REQUIRE_THROWS_AS(decoder.decode(record), std::runtime_error);
+}
+
+TEST_CASE("Parallel generation finds the same graphs as a sequential run", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+
+    std::ostringstream sequential;
+    {
+        fullerene_writer out(sequential);
+        main_generator(out).generate(up_to);
+    }
+
+    std::ostringstream parallel;
+    {
+        fullerene_writer out(parallel);
+        main_generator(out, 3).generate(up_to);
+    }
+
+    // emission order, and with it the ids, depends on scheduling
+    auto expected = text_record_bodies(sequential.str());
+    auto actual = text_record_bodies(parallel.str());
+    std::ranges::sort(expected);
+    std::ranges::sort(actual);
+
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("The slices of a split search together find every graph once", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+    constexpr std::size_t mod = 3;
+
+    std::ostringstream full;
+    {
+        fullerene_writer out(full);
+        main_generator(out).generate(up_to);
+    }
+
+    const std::vector<std::pair<std::size_t, int>> configurations{
+        { 1, 2 },
+        { 2, 2 },
+        { 1, search_split::AUTO_DEPTH },
+    };
+    for (const auto& [threads, depth] : configurations) {
+        std::vector<std::string> ids;
+        std::vector<std::string> actual;
+
+        for (std::size_t res = 0; res < mod; ++res) {
+            std::ostringstream slice;
+            {
+                fullerene_writer out(slice);
+                main_generator(out, threads, { .res = res, .mod = mod, .depth = depth }).generate(up_to);
+            }
+
+            const auto bodies = text_record_bodies(slice.str());
+            actual.insert(actual.end(), bodies.begin(), bodies.end());
+            const auto slice_ids = text_record_ids(slice.str());
+            ids.insert(ids.end(), slice_ids.begin(), slice_ids.end());
+        }
+
+        auto expected = text_record_bodies(full.str());
+        std::ranges::sort(expected);
+        std::ranges::sort(actual);
+        REQUIRE(actual == expected);
+
+        std::ranges::sort(ids);
+        REQUIRE(std::ranges::adjacent_find(ids) == ids.end());
+    }
+
+    std::ostringstream unused;
+    fullerene_writer out(unused);
+    REQUIRE_THROWS_AS(main_generator(out, 1, { .res = 3, .mod = 3 }), std::invalid_argument);
+}
+
+TEST_CASE("Concatenated slices link every graph to the parent it has in a full run", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+    constexpr std::size_t mod = 2;
+
+    // as the generator app runs them, each in a process of its own: the F chain first, written by slice 0 only
+    const auto run = [&](const search_split& split) {
+        id_registry::restore_counters({});
+        std::ostringstream os;
+        {
+            fullerene_writer out(os);
+            auto chain = f_expansion_generator(out);
+            chain.set_written(split.res == 0);
+            chain.generate(up_to);
+            main_generator(out, 1, split).generate(up_to);
+        }
+        return os.str();
+    };
+
+    const auto full = run({});
+    std::string slices;
+    for (std::size_t res = 0; res < mod; ++res) {
+        // deep enough for the graphs every slice registers to reach the sizes of the F chain
+        slices += run({ .res = res, .mod = mod, .depth = 6 });
+    }
+
+    auto expected = text_record_links(full);
+    auto actual = text_record_links(slices);
+    std::ranges::sort(expected);
+    std::ranges::sort(actual);
+    REQUIRE(actual == expected);
+
+    auto ids = text_record_ids(slices);
+    std::ranges::sort(ids);
+    REQUIRE(std::ranges::adjacent_find(ids) == ids.end());
+}
+
+TEST_CASE("The search estimate is close to the size of the search", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+
+    std::ostringstream full;
+    {
+        fullerene_writer out(full);
+        main_generator(out).generate(up_to);
+    }
+    // the C28 seed is not part of the tree below C20
+    const auto graphs = static_cast<double>(text_record_ids(full.str()).size() - 1);
+
+    std::ostringstream unused;
+    fullerene_writer out(unused);
+    const auto estimate = main_generator(out).estimate(up_to, 500);
+
+    REQUIRE(unused.str().empty());
+    REQUIRE(estimate.graphs_per_depth.at(0) == 1);
+    REQUIRE(estimate.graphs_per_size.at(20) == 1);
+    REQUIRE(estimate.graphs > graphs / 2);
+    REQUIRE(estimate.graphs < graphs * 2);
+
+    // fixed seeds make the estimate reproducible, which split runs rely on
+    REQUIRE(main_generator(out).estimate(up_to, 20, 7).graphs_per_depth
+        == main_generator(out).estimate(up_to, 20, 7).graphs_per_depth);
+}
+
+// keeps the first `limit` bytes and fails once, like a run that is killed, then drops everything
+class interrupted_buffer : public std::streambuf {
+    std::string& kept_;
+    std::size_t limit_;
+    bool failed_ = false;
+
+protected:
+    std::streamsize xsputn(const char* s, const std::streamsize n) override {
+        if (failed_) {
+            return n;
+        }
+        if (kept_.size() + static_cast<std::size_t>(n) > limit_) {
+            failed_ = true;
+            throw std::runtime_error("interrupted");
+        }
+        kept_.append(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+    int_type overflow(const int_type c) override {
+        const char ch = traits_type::to_char_type(c);
+        xsputn(&ch, 1);
+        return c;
+    }
+
+public:
+    interrupted_buffer(std::string& kept, const std::size_t limit) : kept_(kept), limit_(limit) {}
+};
+
+TEST_CASE("A resumed search continues exactly where its checkpoint left off", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+    const auto file = (std::filesystem::temp_directory_path() / "fullerene_checkpoint_test").string();
+
+    std::ostringstream full;
+    {
+        fullerene_writer out(full);
+        main_generator(out).generate(up_to);
+    }
+
+    std::string kept;
+    {
+        interrupted_buffer buffer(kept, full.str().size() / 2);
+        std::ostream os(&buffer);
+        os.exceptions(std::ios::badbit);
+        fullerene_writer out(os, output_format::TEXT, 256);
+        auto generator = main_generator(out);
+        generator.enable_checkpoints(file, std::chrono::duration<double>::zero());
+        REQUIRE_THROWS(generator.generate(up_to));
+        // lets the writer's final flush go to the dropped tail quietly
+        os.exceptions(std::ios::goodbit);
+        os.clear();
+    }
+
+    auto checkpoint = read_checkpoint(file);
+    REQUIRE(checkpoint.path.size() > 1);
+    REQUIRE(checkpoint.output_bytes <= kept.size());
+    kept.resize(checkpoint.output_bytes);
+
+    std::ostringstream rest;
+    {
+        fullerene_writer out(rest, output_format::TEXT, continued_stream{ checkpoint.output_bytes });
+        auto generator = main_generator(out);
+        generator.resume_from(std::move(checkpoint));
+        generator.generate(up_to);
+    }
+    std::filesystem::remove(file);
+
+    // ids continue from the interrupted run's counters, so only the graphs can be compared with the full run
+    REQUIRE(text_record_bodies(kept + rest.str()) == text_record_bodies(full.str()));
+    auto ids = text_record_ids(kept + rest.str());
+    std::ranges::sort(ids);
+    REQUIRE(std::ranges::adjacent_find(ids) == ids.end());
+}
+
+TEST_CASE("Ids of any size are numbered and survive a checkpoint", "[id_registry]") {
+    id_registry::restore_counters({});
+    // far beyond anything the searches above reach, in a scope of its own
+    constexpr std::uint32_t scope = 7;
+    for (const std::uint32_t atoms : { 20u, 20000u, 4000000u }) {
+        REQUIRE(id_registry::register_id(atoms, scope).ordinal == 0);
+        REQUIRE(id_registry::register_id(atoms, scope).ordinal == 1);
+    }
+
+    const auto counters = id_registry::get_counters();
+    REQUIRE(counters == id_registry::counter_map{
+        { { scope, 20 }, 2 }, { { scope, 20000 }, 2 }, { { scope, 4000000 }, 2 } });
+
+    id_registry::restore_counters({});
+    REQUIRE(id_registry::register_id(20000, scope).ordinal == 0);
+    id_registry::restore_counters(counters);
+    REQUIRE(id_registry::register_id(20000, scope).ordinal == 2);
+    REQUIRE(id_registry::register_id(4000000, scope).ordinal == 2);
+}
+
+TEST_CASE("Counting runs tally the isomers a full run writes", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+
+    std::ostringstream full;
+    {
+        fullerene_writer out(full);
+        main_generator(out).generate(up_to);
+    }
+    std::vector<std::uint64_t> expected(up_to + 1);
+    for (const auto& body : text_record_bodies(full.str())) {
+        // a record body holds the outer face and then one line per atom
+        expected[std::ranges::count(body, '\n') - 1]++;
+    }
+
+    std::ostringstream counted;
+    fullerene_writer out(counted, output_format::COUNT);
+    main_generator(out).generate(up_to);
+    REQUIRE(counted.str().empty());
+
+    const auto& counts = out.get_counts();
+    REQUIRE(counts.size() == up_to + 1);
+    for (std::size_t atoms = 0; atoms <= up_to; ++atoms) {
+        REQUIRE(counts[atoms].isomers == expected[atoms]);
+        REQUIRE(counts[atoms].ipr == 0);
+    }
+    // the isomers of C50 besides the F-expansion chain, which the main generator doesn't reach
+    REQUIRE(counts[50].isomers == 270);
+
+    out.write_counts();
+    out.flush();
+    REQUIRE(counted.str().ends_with("total " + std::to_string(std::accumulate(expected.begin(), expected.end(), std::uint64_t{ 0 })) + " 0\n"));
+}
+
+TEST_CASE("A size range writes only the graphs of a full run within it", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+    constexpr std::size_t min_size = 46;
+
+    std::ostringstream full;
+    {
+        fullerene_writer out(full);
+        main_generator(out).generate(up_to);
+    }
+    std::vector<std::string> expected;
+    for (const auto& body : text_record_bodies(full.str())) {
+        if (static_cast<std::size_t>(std::ranges::count(body, '\n') - 1) >= min_size) {
+            expected.push_back(body);
+        }
+    }
+
+    std::ostringstream ranged;
+    {
+        fullerene_writer out(ranged);
+        auto generator = main_generator(out);
+        generator.set_emitted_sizes(min_size, up_to);
+        generator.generate(up_to);
+    }
+
+    REQUIRE_FALSE(expected.empty());
+    REQUIRE(text_record_bodies(ranged.str()) == expected);
+}
+
+TEST_CASE("An IPR run finds the IPR isomer of C60 alone", "[main_generator]") {
+    constexpr std::size_t up_to = 60;
+
+    std::ostringstream unused;
+    fullerene_writer out(unused, output_format::COUNT);
+    auto generator = main_generator(out);
+    generator.set_min_pentagon_distance(2);
+    generator.generate(up_to);
+
+    const auto& counts = out.get_counts();
+    REQUIRE(counts.size() == up_to + 1);
+    for (std::size_t atoms = 0; atoms < up_to; ++atoms) {
+        REQUIRE(counts[atoms].isomers == 0);
+    }
+    REQUIRE(counts[up_to].isomers == 1);
+    REQUIRE(counts[up_to].ipr == 1);
+}
+
+TEST_CASE("The output pipeline writes what the search thread would have", "[emit_pipeline]") {
+    constexpr std::size_t up_to = 50;
+
+    for (const auto format : { output_format::TEXT, output_format::DELTA }) {
+        std::ostringstream direct;
+        {
+            fullerene_writer out(direct, format);
+            main_generator(out).generate(up_to);
+        }
+
+        std::ostringstream piped;
+        std::size_t records = 0;
+        {
+            fullerene_writer out(piped, format);
+            // a small ring makes the search wait for the output thread now and then
+            emit_pipeline pipeline(out, 4);
+            auto generator = main_generator(out);
+            generator.set_pipeline(&pipeline);
+            generator.generate(up_to);
+            pipeline.drain();
+            records = pipeline.get_stats().records;
+        }
+
+        if (format == output_format::TEXT) {
+            const auto expected = text_record_bodies(direct.str());
+            REQUIRE(text_record_bodies(piped.str()) == expected);
+            REQUIRE(records == expected.size());
+        }
+        else {
+            // ids differ between runs in one process, the steps and their order don't
+            const auto steps = [](const std::string& delta) {
+                std::istringstream is(delta);
+                REQUIRE(read_delta_header(is));
+                std::vector<std::string> lines;
+                std::string line;
+                std::getline(is, line);
+                while (std::getline(is, line)) {
+                    const auto first = line.find(' ');
+                    lines.push_back(line.substr(line.find(' ', first + 1)));
+                }
+                return lines;
+            };
+            REQUIRE(steps(piped.str()) == steps(direct.str()));
+        }
+    }
+}
+
+TEST_CASE("Ordered parallel output is the output of a sequential run", "[main_generator]") {
+    constexpr std::size_t up_to = 50;
+    constexpr std::size_t threads = 3;
+
+    for (const auto format : { output_format::TEXT, output_format::DELTA }) {
+        // both runs start numbering from scratch, so their ids have to agree as well
+        id_registry::restore_counters({});
+        std::ostringstream sequential;
+        {
+            fullerene_writer out(sequential, format);
+            main_generator(out).generate(up_to);
+        }
+
+        // a tiny window makes the threads ahead wait and help out the one writing
+        for (const std::size_t window : { std::size_t{ 4 }, main_generator::DEFAULT_REORDER_WINDOW }) {
+            id_registry::restore_counters({});
+            std::ostringstream parallel;
+            reorder_stats stats;
+            {
+                fullerene_writer out(parallel, format);
+                auto generator = main_generator(out, threads);
+                generator.set_ordered_output(window);
+                generator.generate(up_to);
+                stats = generator.get_reorder_stats();
+            }
+
+            REQUIRE(parallel.str() == sequential.str());
+            // threads that passed the check at the same time may append one record each beyond the window
+            REQUIRE(stats.peak_buffered <= window + threads);
+            REQUIRE(stats.records > 0);
+        }
+    }
+}
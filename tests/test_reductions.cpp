@@ -6,9 +6,13 @@
 
 #include <expansions/b_expansion.h>
 #include <expansions/b_reduction.h>
+#include <expansions/reduction_catalogue.h>
 
 #include <fullerene/construct.h>
 
+#include <algorithm>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include <string>
 
@@ -18,10 +22,10 @@ static std::vector<std::vector<unsigned int>> snapshot_rotations(const dual_full
     std::vector<std::vector<unsigned int>> rot(n);
 
     for (std::size_t id = 0; id < n; ++id) {
-        auto v = G.get_node(static_cast<unsigned int>(id));
-        rot[id].reserve(v->degree());
-        for (std::size_t k = 0; k < v->degree(); ++k) {
-            rot[id].push_back(v->neighbor_at(k)->id());
+        const auto v = static_cast<unsigned int>(id);
+        rot[id].reserve(G.degree(v));
+        for (std::size_t k = 0; k < G.degree(v); ++k) {
+            rot[id].push_back(G.neighbor_at(v, k));
         }
     }
 
@@ -148,3 +152,255 @@ TEST_CASE("B reductions undo B expansions exactly (C28)") {
     run_one_case_B(&create_c28_fullerene, 0, 2, "C28");
     run_one_case_B(&create_c28_fullerene, 1, 1, "C28");
 }
+
+TEST_CASE("Rollback undoes every expansion of a graph exactly") {
+    auto G = create_c28_fullerene();
+    const auto before = G;
+
+    auto exps = find_l_expansions(G, 0);
+    auto bs = find_b_expansions(G, 0, 1);
+    for (auto& e : bs) {
+        exps.push_back(std::move(e));
+    }
+    REQUIRE_FALSE(exps.empty());
+
+    for (const auto& e : exps) {
+        if (!e->validate()) {
+            continue;
+        }
+
+        const auto mark = G.checkpoint();
+        e->apply();
+        validate_dual_fullerene(G);
+        G.rollback(mark);
+
+        validate_dual_fullerene(G);
+        require_same_graph(G, before);
+    }
+}
+
+TEST_CASE("Nested checkpoints roll back independently") {
+    auto G = create_c20_fullerene();
+    const auto before = G;
+
+    const auto outer = G.checkpoint();
+    auto first = find_l_expansions(G, 0);
+    REQUIRE(first.front()->validate());
+    first.front()->apply();
+    const auto after_first = G;
+
+    const auto inner = G.checkpoint();
+    auto second = find_l_expansions(G, 0);
+    REQUIRE(second.front()->validate());
+    second.front()->apply();
+
+    G.rollback(inner);
+    require_same_graph(G, after_first);
+
+    G.rollback(outer);
+    validate_dual_fullerene(G);
+    require_same_graph(G, before);
+
+    REQUIRE_THROWS_AS(G.rollback(outer), std::logic_error);
+}
+
+TEST_CASE("Reserved vertex storage is recycled across expansions") {
+    auto G = create_c20_fullerene();
+    G.reserve(G.total_nodes() + 16);
+    const auto fresh = G.get_storage_stats().fresh_vertices;
+
+    auto exps = find_l_expansions(G, 1);
+    REQUIRE_FALSE(exps.empty());
+
+    // every L(1) adds the same vertices, only the first one applied takes rows no vertex held before
+    std::size_t added = 0;
+    for (int round = 0; round < 2; ++round) {
+        for (const auto& e : exps) {
+            if (!e->validate()) {
+                continue;
+            }
+
+            const auto mark = G.checkpoint();
+            const auto before = G.total_nodes();
+            e->apply();
+            added = G.total_nodes() - before;
+            G.rollback(mark);
+        }
+    }
+
+    REQUIRE(added > 0);
+    REQUIRE(G.get_storage_stats().fresh_vertices == fresh + added);
+    REQUIRE(G.get_storage_stats().recycled_vertices > 0);
+}
+
+// the (pentagon, slot, direction, x0, x1) of each reduction, in order
+static std::vector<std::tuple<unsigned, unsigned, bool, int, int>> reduction_keys(const std::vector<const base_reduction*>& reductions)
+{
+    std::vector<std::tuple<unsigned, unsigned, bool, int, int>> keys;
+    for (const auto* r : reductions) {
+        keys.emplace_back(r->first_edge.from, r->first_edge.index, r->use_next, r->x0(), r->x1());
+    }
+    return keys;
+}
+
+// the keys of the reductions of x0 as the per-size enumerators find them, leaving out the one a catalogue's
+// collect skips for the same arguments
+static std::vector<std::tuple<unsigned, unsigned, bool, int, int>> enumerated_keys(const dual_fullerene& G, const int x0,
+    const int skip_pent, const int skip_index, const bool skip_clockwise, const int skip_l1)
+{
+    std::vector<const base_reduction*> found;
+    const auto ls = skip_l1 < 0
+        ? find_l_reductions(G, x0, skip_pent, skip_index, skip_clockwise)
+        : find_l_reductions(G, x0, -1, -1, true);
+    for (const auto& r : ls) {
+        found.push_back(&r);
+    }
+    std::vector<std::vector<b_reduction>> bs;
+    for (int pre = 0; pre <= x0 - 2; ++pre) {
+        bs.push_back(pre == skip_l1
+            ? find_b_reductions(G, pre, x0 - 2 - pre, skip_pent, skip_index, skip_clockwise)
+            : find_b_reductions(G, pre, x0 - 2 - pre, -1, -1, true));
+    }
+    for (const auto& by_pre : bs) {
+        for (const auto& r : by_pre) {
+            found.push_back(&r);
+        }
+    }
+    return reduction_keys(found);
+}
+
+TEST_CASE("The reduction catalogue lists what the per-size enumerators find") {
+    auto G = create_c28_fullerene();
+    reduction_catalogue reductions(G);
+
+    auto exps = find_l_expansions(G, 0);
+    auto bs = find_b_expansions(G, 0, 0);
+    for (auto& e : bs) {
+        exps.push_back(std::move(e));
+    }
+    REQUIRE_FALSE(exps.empty());
+
+    for (const auto& e : exps) {
+        if (!e->validate()) {
+            continue;
+        }
+
+        const auto mark = G.checkpoint();
+        e->apply();
+        reductions.reset();
+
+        for (int x0 = 1; x0 <= 4; ++x0) {
+            const auto expected = enumerated_keys(G, x0, -1, -1, true, -1);
+            std::vector<const base_reduction*> listed;
+            reductions.collect(x0, -1, -1, true, -1, listed);
+            REQUIRE(reduction_keys(listed) == expected);
+            REQUIRE(reductions.has_reductions(x0) == !expected.empty());
+
+            // skipping any one of them leaves out the same reduction
+            for (const auto* first : listed) {
+                const auto* b = dynamic_cast<const b_reduction*>(first);
+                const int skip_l1 = b != nullptr ? b->length_pre_bend : -1;
+                const auto pent = static_cast<int>(first->first_edge.from);
+                const auto index = static_cast<int>(first->first_edge.index);
+                std::vector<const base_reduction*> kept_listed;
+                reductions.collect(x0, pent, index, first->use_next, skip_l1, kept_listed);
+                REQUIRE(reduction_keys(kept_listed) == enumerated_keys(G, x0, pent, index, first->use_next, skip_l1));
+            }
+        }
+
+        G.rollback(mark);
+    }
+}
+
+TEST_CASE("A reduction catalogue derived from the parent's lists what a fresh one lists") {
+    // a graph large enough for expansions to leave pentagons far from their patch
+    auto G = create_c28_fullerene();
+    for (int grown = 0; grown < 6; ++grown) {
+        auto exps = find_l_expansions(G, 2);
+        const auto valid = std::ranges::find_if(exps, [](const auto& e) { return e->validate(); });
+        REQUIRE(valid != exps.end());
+        (*valid)->apply();
+    }
+
+    reduction_catalogue parent(G);
+    reduction_catalogue derived(G);
+    reduction_catalogue fresh(G);
+
+    std::vector<std::unique_ptr<base_expansion>> exps;
+    for (int size = 0; size <= 2; ++size) {
+        for (auto& e : find_l_expansions(G, size)) {
+            exps.push_back(std::move(e));
+        }
+    }
+    for (auto& e : find_b_expansions(G, 0, 1)) {
+        exps.push_back(std::move(e));
+    }
+    REQUIRE_FALSE(exps.empty());
+
+    for (const auto& e : exps) {
+        if (!e->validate()) {
+            continue;
+        }
+
+        const auto mark = G.checkpoint();
+        e->apply();
+        derived.reset(parent, mark, 4);
+        fresh.reset();
+
+        // x0 5 lies beyond what the derived catalogue was set up for
+        for (int x0 = 1; x0 <= 5; ++x0) {
+            REQUIRE(derived.has_reductions(x0) == fresh.has_reductions(x0));
+            std::vector<const base_reduction*> expected;
+            fresh.collect(x0, -1, -1, true, -1, expected);
+            std::vector<const base_reduction*> listed;
+            derived.collect(x0, -1, -1, true, -1, listed);
+            REQUIRE(reduction_keys(listed) == reduction_keys(expected));
+        }
+
+        G.rollback(mark);
+    }
+}
+
+TEST_CASE("One walk per pentagon finds the reductions of every size") {
+    constexpr int max_x0 = 5;
+
+    for (const auto& G : { create_c20_fullerene(), create_c28_fullerene(), create_c30_fullerene() }) {
+        for (const auto pentagon : G.get_nodes_5()) {
+            std::vector<l_reduction> ls;
+            std::vector<b_reduction> bs;
+            find_reductions_at(G, pentagon, 1, max_x0, ls, bs);
+
+            // ask the per-size enumerators for the same sizes and compare pentagon by pentagon
+            for (int x0 = 1; x0 <= max_x0; ++x0) {
+                std::vector<const base_reduction*> expected;
+                const auto all_l = find_l_reductions(G, x0, -1, -1, true);
+                for (const auto& r : all_l) {
+                    if (r.first_edge.from == pentagon) expected.push_back(&r);
+                }
+                std::vector<std::vector<b_reduction>> all_b;
+                for (int pre = 0; pre <= x0 - 2; ++pre) {
+                    all_b.push_back(find_b_reductions(G, pre, x0 - 2 - pre, -1, -1, true));
+                }
+                for (const auto& by_pre : all_b) {
+                    for (const auto& r : by_pre) {
+                        if (r.first_edge.from == pentagon) expected.push_back(&r);
+                    }
+                }
+
+                std::vector<const base_reduction*> found;
+                for (const auto& r : ls) {
+                    if (r.x0() == x0) found.push_back(&r);
+                }
+                for (int pre = 0; pre <= x0 - 2; ++pre) {
+                    for (const auto& r : bs) {
+                        if (r.x0() == x0 && r.length_pre_bend == pre) found.push_back(&r);
+                    }
+                }
+                REQUIRE(reduction_keys(found) == reduction_keys(expected));
+                for (std::size_t k = 0; k < found.size(); ++k) {
+                    REQUIRE(found[k]->second_edge == expected[k]->second_edge);
+                }
+            }
+        }
+    }
+}